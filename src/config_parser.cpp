@@ -7,9 +7,11 @@
 #include <stdplus/fd/line.hpp>
 #include <stdplus/str/cat.hpp>
 
+#include <algorithm>
 #include <format>
 #include <functional>
 #include <iterator>
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -81,6 +83,53 @@ std::vector<std::string> SectionMap::getValueStrings(std::string_view section,
                      [](const Value& v) { return std::string(v); });
 }
 
+/** @brief A config reduced to the parts networkd acts on, in a fixed order */
+using CanonicalMap = std::map<
+    std::string_view,
+    std::vector<std::map<std::string_view, std::vector<std::string_view>>>>;
+
+static CanonicalMap canonicalize(const SectionMap& map)
+{
+    CanonicalMap ret;
+    for (const auto& [section, kvss] : map)
+    {
+        std::vector<std::map<std::string_view, std::vector<std::string_view>>>
+            out;
+        for (const auto& kvs : kvss)
+        {
+            std::map<std::string_view, std::vector<std::string_view>> kvo;
+            for (const auto& [key, vals] : kvs)
+            {
+                if (vals.empty())
+                {
+                    continue;
+                }
+                auto& valso = kvo[key.get()];
+                for (const auto& val : vals)
+                {
+                    valso.push_back(val.get());
+                }
+            }
+            if (!kvo.empty())
+            {
+                out.push_back(std::move(kvo));
+            }
+        }
+        if (out.empty())
+        {
+            continue;
+        }
+        std::sort(out.begin(), out.end());
+        ret.emplace(section.get(), std::move(out));
+    }
+    return ret;
+}
+
+bool equivalent(const SectionMap& a, const SectionMap& b)
+{
+    return canonicalize(a) == canonicalize(b);
+}
+
 void KeyCheck::operator()(std::string_view s)
 {
     for (auto c : s)
@@ -146,6 +146,14 @@ class SectionMap : public SectionMapInt
                                              std::string_view key) const;
 };
 
+/** @brief Determines if two configs mean the same thing to networkd
+ *
+ *  @details Keys without any values are the same as missing keys, and
+ *           repeated sections, such as one [Route] per route, may appear in
+ *           any order. The order of values within a key is kept.
+ */
+bool equivalent(const SectionMap& a, const SectionMap& b);
+
 class Parser
 {
   public:
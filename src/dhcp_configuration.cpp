@@ -42,7 +42,7 @@ bool Configuration::sendHostNameEnabled(bool value)
     }
 
     auto name = ConfigIntf::sendHostNameEnabled(value);
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().reloadConfigs();
     return name;
 }
@@ -55,7 +55,7 @@ bool Configuration::hostNameEnabled(bool value)
     }
 
     auto name = ConfigIntf::hostNameEnabled(value);
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().reloadConfigs();
 
     return name;
@@ -69,7 +69,7 @@ bool Configuration::ntpEnabled(bool value)
     }
 
     auto ntp = ConfigIntf::ntpEnabled(value);
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().reloadConfigs();
 
     return ntp;
@@ -83,7 +83,7 @@ bool Configuration::dnsEnabled(bool value)
     }
 
     auto dns = ConfigIntf::dnsEnabled(value);
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().reloadConfigs();
 
     return dns;
@@ -97,7 +97,7 @@ bool Configuration::domainEnabled(bool value)
     }
 
     auto domain = ConfigIntf::domainEnabled(value);
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().reloadConfigs();
 
     return domain;
@@ -23,6 +23,7 @@
 #include <xyz/openbmc_project/Common/error.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <string>
@@ -96,7 +97,7 @@ EthernetInterface::EthernetInterface(
     stdplus::PinnedRef<Manager> manager, const AllIntfInfo& info,
     std::string&& objPath, const config::Parser& config, bool enabled) :
     Ifaces(bus, objPath.c_str(), Ifaces::action::defer_emit), manager(manager),
-    bus(bus), objPath(std::move(objPath))
+    bus(bus), objPath(std::move(objPath)), applyNowEnabled(APPLY_NOW)
 {
     // 设置接口名称
     interfaceName(*info.intf.name, true);
@@ -374,27 +375,51 @@ ObjectPath EthernetInterface::ip(IP::Protocol protType, std::string ipaddress,
             Argument::ARGUMENT_VALUE(stdplus::toStr(prefixLength).c_str()));
     }
 
-    auto it = addrs.find(*ifaddr);
+    auto [addr, changed] = addStaticAddr(*ifaddr);
+    if (changed)
+    {
+        markConfigDirty();
+        manager.get().reloadConfigs();
+    }
+
+    return addr.getObjPath();
+}
+
+std::pair<IPAddress&, bool>
+    EthernetInterface::addStaticAddr(stdplus::SubnetAny ifaddr)
+{
+    auto it = addrs.find(ifaddr);
     if (it == addrs.end())
     {
         it = std::get<0>(addrs.emplace(
-            *ifaddr,
+            ifaddr,
             std::make_unique<IPAddress>(bus, std::string_view(objPath), *this,
-                                        *ifaddr, IP::AddressOrigin::Static)));
+                                        ifaddr, IP::AddressOrigin::Static)));
+    }
+    else if (it->second->origin() == IP::AddressOrigin::Static)
+    {
+        return {*it->second, false};
     }
     else
     {
-        if (it->second->origin() == IP::AddressOrigin::Static)
-        {
-            return it->second->getObjPath();
-        }
         it->second->IPIfaces::origin(IP::AddressOrigin::Static);
     }
+    applyNow("address", [&](unsigned idx) { system::addAddress(idx, ifaddr); });
+    return {*it->second, true};
+}
 
-    writeConfigurationFile();
-    manager.get().reloadConfigs();
-
-    return it->second->getObjPath();
+bool EthernetInterface::removeStaticAddr(stdplus::SubnetAny ifaddr)
+{
+    auto it = addrs.find(ifaddr);
+    if (it == addrs.end() ||
+        it->second->origin() != IP::AddressOrigin::Static)
+    {
+        return false;
+    }
+    applyNow("address removal",
+             [&](unsigned idx) { system::deleteAddress(idx, ifaddr); });
+    addrs.erase(it);
+    return true;
 }
 
 ObjectPath EthernetInterface::neighbor(std::string ipAddress,
@@ -444,7 +469,10 @@ ObjectPath EthernetInterface::neighbor(std::string ipAddress,
         it->second->NeighborObj::macAddress(str);
     }
 
-    writeConfigurationFile();
+    applyNow("neighbor", [&](unsigned idx) {
+        system::addNeighbor(idx, *addr, *lladdr);
+    });
+    markConfigDirty();
     manager.get().reloadConfigs();
 
     return it->second->getObjPath();
@@ -491,7 +519,10 @@ ObjectPath EthernetInterface::staticGateway(std::string gateway,
         it->second->StaticGatewayObj::gateway(gateway);
     }
 
-    writeConfigurationFile();
+    applyNow("static gateway", [&](unsigned idx) {
+        system::addDefaultRoute(idx, *addr, /*onlink=*/true);
+    });
+    markConfigDirty();
     manager.get().reloadConfigs();
 
     return it->second->getObjPath();
@@ -499,34 +530,49 @@ ObjectPath EthernetInterface::staticGateway(std::string gateway,
 
 bool EthernetInterface::ipv6AcceptRA(bool value)
 {
-    if (ipv6AcceptRA() != EthernetInterfaceIntf::ipv6AcceptRA(value))
+    if (updateIPv6AcceptRA(value))
     {
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().reloadConfigs();
     }
     return value;
 }
 
+bool EthernetInterface::updateIPv6AcceptRA(bool value)
+{
+    return ipv6AcceptRA() != EthernetInterfaceIntf::ipv6AcceptRA(value);
+}
+
 bool EthernetInterface::dhcp4(bool value)
 {
-    if (dhcp4() != EthernetInterfaceIntf::dhcp4(value))
+    if (updateDHCP4(value))
     {
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().reloadConfigs();
     }
     return value;
 }
 
+bool EthernetInterface::updateDHCP4(bool value)
+{
+    return dhcp4() != EthernetInterfaceIntf::dhcp4(value);
+}
+
 bool EthernetInterface::dhcp6(bool value)
 {
-    if (dhcp6() != EthernetInterfaceIntf::dhcp6(value))
+    if (updateDHCP6(value))
     {
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().reloadConfigs();
     }
     return value;
 }
 
+bool EthernetInterface::updateDHCP6(bool value)
+{
+    return dhcp6() != EthernetInterfaceIntf::dhcp6(value);
+}
+
 EthernetInterface::DHCPConf EthernetInterface::dhcpEnabled(DHCPConf value)
 {
     auto old4 = EthernetInterfaceIntf::dhcp4();
@@ -543,7 +589,7 @@ EthernetInterface::DHCPConf EthernetInterface::dhcpEnabled(DHCPConf value)
 
     if (old4 != new4 || old6 != new6 || oldra != newra)
     {
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().reloadConfigs();
     }
     return value;
@@ -578,19 +624,26 @@ size_t EthernetInterface::mtu(size_t value)
 
 bool EthernetInterface::nicEnabled(bool value)
 {
-    if (value == EthernetInterfaceIntf::nicEnabled())
+    if (updateNICEnabled(value))
     {
-        return value;
+        markConfigDirty();
+        manager.get().reloadConfigs();
     }
+    return value;
+}
 
+bool EthernetInterface::updateNICEnabled(bool value)
+{
+    if (value == EthernetInterfaceIntf::nicEnabled())
+    {
+        return false;
+    }
     EthernetInterfaceIntf::nicEnabled(value);
-    writeConfigurationFile();
-    manager.get().reloadConfigs();
-
-    return value;
+    return true;
 }
 
-ServerList EthernetInterface::staticNameServers(ServerList value)
+/** @brief Normalizes the given DNS servers and drops any duplicates */
+static ServerList uniqueNameServers(ServerList value)
 {
     std::vector<std::string> dnsUniqueValues;
     for (auto& ip : value)
@@ -612,16 +665,30 @@ ServerList EthernetInterface::staticNameServers(ServerList value)
             dnsUniqueValues.push_back(ip);
         }
     }
+    return dnsUniqueValues;
+}
 
-    value =
-        EthernetInterfaceIntf::staticNameServers(std::move(dnsUniqueValues));
+ServerList EthernetInterface::staticNameServers(ServerList value)
+{
+    value = uniqueNameServers(std::move(value));
+    updateStaticNameServers(value);
 
-    writeConfigurationFile();
+    markConfigDirty();
     manager.get().reloadConfigs();
 
     return value;
 }
 
+bool EthernetInterface::updateStaticNameServers(const ServerList& value)
+{
+    if (value == EthernetInterfaceIntf::staticNameServers())
+    {
+        return false;
+    }
+    EthernetInterfaceIntf::staticNameServers(value);
+    return true;
+}
+
 void EthernetInterface::loadNTPServers(const config::Parser& config)
 {
     ServerList ntpServerList = getNTPServerFromTimeSyncd();
@@ -766,7 +833,7 @@ ObjectPath EthernetInterface::createVLAN(uint16_t id)
         bus, manager, info, objRoot, config::Parser(), nicEnabled());
     ObjectPath ret = vlanIntf->objPath;
 
-    manager.get().interfaces.emplace(intfName, std::move(vlanIntf));
+    manager.get().insertIntf(std::move(vlanIntf));
 
     // write the device file for the vlan interface.
     config::Parser config;
@@ -776,8 +843,9 @@ ObjectPath EthernetInterface::createVLAN(uint16_t id)
     config.map["VLAN"].emplace_back()["Id"].emplace_back(std::move(idStr));
     config.writeFile(
         config::pathForIntfDev(manager.get().getConfDir(), intfName));
+    manager.get().markNetdevChanged();
 
-    writeConfigurationFile();
+    markConfigDirty();
     manager.get().reloadConfigs();
 
     return ret;
@@ -785,14 +853,24 @@ ObjectPath EthernetInterface::createVLAN(uint16_t id)
 
 ServerList EthernetInterface::staticNTPServers(ServerList value)
 {
-    value = EthernetInterfaceIntf::staticNTPServers(std::move(value));
+    updateStaticNTPServers(value);
 
-    writeConfigurationFile();
+    markConfigDirty();
     manager.get().reloadConfigs();
 
     return value;
 }
 
+bool EthernetInterface::updateStaticNTPServers(const ServerList& value)
+{
+    if (value == EthernetInterfaceIntf::staticNTPServers())
+    {
+        return false;
+    }
+    EthernetInterfaceIntf::staticNTPServers(value);
+    return true;
+}
+
 ServerList EthernetInterface::ntpServers(ServerList /*servers*/)
 {
     elog<NotAllowed>(NotAllowedArgument::REASON("ReadOnly Property"));
@@ -834,8 +912,35 @@ static void writeUpdatedTime(const Manager& manager,
     }
 }
 
+// ApplyNow 打开且链路存在时把修改直接下发给内核，
+// 下发失败只记录日志，由随后的 networkd 重载应用配置
+void EthernetInterface::applyNow(std::string_view what,
+                                 stdplus::function_view<void(unsigned)> apply)
+{
+    // The link has to exist for the kernel to take the change
+    if (!applyNowEnabled || ifIdx == 0)
+    {
+        return;
+    }
+    try
+    {
+        apply(ifIdx);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to apply {WHAT} on {NET_INTF}, waiting for "
+                   "networkd: {ERROR}",
+                   "WHAT", what, "NET_INTF", interfaceName(), "ERROR", e);
+    }
+}
+
+void EthernetInterface::markConfigDirty()
+{
+    manager.get().queueConfigFlush(interfaceName());
+}
+
 // 根据 EthernetInterfaceIntf dbus信息来更新网络接口的配置文件
-void EthernetInterface::writeConfigurationFile()
+bool EthernetInterface::writeConfigurationFile()
 {
     config::Parser config;
     config.map["Match"].emplace_back()["Name"].emplace_back(interfaceName());
@@ -965,9 +1070,17 @@ void EthernetInterface::writeConfigurationFile()
 
     auto path =
         config::pathForIntfConf(manager.get().getConfDir(), interfaceName());
+    if (config::equivalent(config::Parser(path).map, config.map))
+    {
+        lg2::debug("Unchanged networkd file: {CFG_FILE}", "CFG_FILE", path);
+        return false;
+    }
     config.writeFile(path);
+    configWrites++;
+    manager.get().countConfigWrite();
     lg2::info("Wrote networkd file: {CFG_FILE}", "CFG_FILE", path);
     writeUpdatedTime(manager, path);
+    return true;
 }
 
 std::string EthernetInterface::macAddress([[maybe_unused]] std::string value)
@@ -1016,7 +1129,7 @@ std::string EthernetInterface::macAddress([[maybe_unused]] std::string value)
         }
         MacAddressIntf::macAddress(validMAC);
 
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().addReloadPreHook([interface, manager = manager]() {
             // The MAC and LLADDRs will only update if the NIC is already down
             system::setNICUp(interface, false);
@@ -1052,7 +1165,7 @@ void EthernetInterface::deleteAll()
     // clear all the ip on the interface
     addrs.clear();
 
-    writeConfigurationFile();
+    markConfigDirty();
     manager.get().reloadConfigs();
 }
 
@@ -1085,30 +1198,234 @@ static void normalizeGateway(std::string& gw)
     }
 }
 
+/** @brief Moves the default route of a link between gateways, either of
+ *         which may be empty
+ */
+static void moveDefaultRoute(unsigned ifidx, std::string_view from,
+                             std::string_view to)
+{
+    if (!from.empty())
+    {
+        system::deleteDefaultRoute(ifidx,
+                                   stdplus::fromStr<stdplus::InAnyAddr>(from));
+    }
+    if (!to.empty())
+    {
+        system::addDefaultRoute(ifidx, stdplus::fromStr<stdplus::InAnyAddr>(to),
+                                /*onlink=*/false);
+    }
+}
+
 std::string EthernetInterface::defaultGateway(std::string gateway)
 {
     normalizeGateway<stdplus::In4Addr>(gateway);
-    if (gateway != defaultGateway())
+    if (updateDefaultGateway(gateway))
     {
-        gateway = EthernetInterfaceIntf::defaultGateway(std::move(gateway));
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().reloadConfigs();
     }
     return gateway;
 }
 
+bool EthernetInterface::updateDefaultGateway(const std::string& gateway)
+{
+    auto old = defaultGateway();
+    if (gateway == old)
+    {
+        return false;
+    }
+    EthernetInterfaceIntf::defaultGateway(gateway);
+    applyNow("gateway", [&](unsigned idx) {
+        moveDefaultRoute(idx, old, gateway);
+    });
+    return true;
+}
+
 std::string EthernetInterface::defaultGateway6(std::string gateway)
 {
     normalizeGateway<stdplus::In6Addr>(gateway);
-    if (gateway != defaultGateway6())
+    if (updateDefaultGateway6(gateway))
     {
-        gateway = EthernetInterfaceIntf::defaultGateway6(std::move(gateway));
-        writeConfigurationFile();
+        markConfigDirty();
         manager.get().reloadConfigs();
     }
     return gateway;
 }
 
+bool EthernetInterface::updateDefaultGateway6(const std::string& gateway)
+{
+    auto old = defaultGateway6();
+    if (gateway == old)
+    {
+        return false;
+    }
+    EthernetInterfaceIntf::defaultGateway6(gateway);
+    applyNow("gateway", [&](unsigned idx) {
+        moveDefaultRoute(idx, old, gateway);
+    });
+    return true;
+}
+
+template <typename T>
+static T& changeAs(const std::string& name, EthernetInterface::Change& value)
+{
+    auto ret = std::get_if<T>(&value);
+    if (ret == nullptr)
+    {
+        lg2::error("Wrong type for change {NAME}", "NAME", name);
+        elog<InvalidArgument>(Argument::ARGUMENT_NAME(name.c_str()),
+                              Argument::ARGUMENT_VALUE("Wrong type"));
+    }
+    return *ret;
+}
+
+static stdplus::SubnetAny parseStaticAddr(const std::string& str)
+{
+    try
+    {
+        auto ifaddr = stdplus::fromStr<stdplus::SubnetAny>(str);
+        if (ifaddr.getPfx() == 0)
+        {
+            throw std::invalid_argument("default route");
+        }
+        if (!std::visit([](auto ip) { return validIntfIP(ip); },
+                        ifaddr.getAddr()))
+        {
+            throw std::invalid_argument("not unicast");
+        }
+        return ifaddr;
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Invalid static address {NET_IP}: {ERROR}", "NET_IP", str,
+                   "ERROR", e);
+        elog<InvalidArgument>(Argument::ARGUMENT_NAME("StaticAddresses"),
+                              Argument::ARGUMENT_VALUE(str.c_str()));
+    }
+}
+
+void EthernetInterface::applyChanges(std::map<std::string, Change> changes)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // Validate everything up front so a bad entry leaves the interface alone
+    std::optional<bool> newDhcp4, newDhcp6, newRA, newNicEnabled;
+    std::optional<std::string> newGw4, newGw6;
+    std::optional<ServerList> newDns, newNtp;
+    std::optional<std::vector<stdplus::SubnetAny>> newAddrs;
+    for (auto& [name, value] : changes)
+    {
+        if (name == "DHCP4")
+        {
+            newDhcp4 = changeAs<bool>(name, value);
+        }
+        else if (name == "DHCP6")
+        {
+            newDhcp6 = changeAs<bool>(name, value);
+        }
+        else if (name == "IPv6AcceptRA")
+        {
+            newRA = changeAs<bool>(name, value);
+        }
+        else if (name == "NICEnabled")
+        {
+            newNicEnabled = changeAs<bool>(name, value);
+        }
+        else if (name == "DefaultGateway")
+        {
+            auto& gw = changeAs<std::string>(name, value);
+            normalizeGateway<stdplus::In4Addr>(gw);
+            newGw4 = std::move(gw);
+        }
+        else if (name == "DefaultGateway6")
+        {
+            auto& gw = changeAs<std::string>(name, value);
+            normalizeGateway<stdplus::In6Addr>(gw);
+            newGw6 = std::move(gw);
+        }
+        else if (name == "StaticNameServers")
+        {
+            newDns = uniqueNameServers(
+                std::move(changeAs<ServerList>(name, value)));
+        }
+        else if (name == "StaticNTPServers")
+        {
+            newNtp = std::move(changeAs<ServerList>(name, value));
+        }
+        else if (name == "StaticAddresses")
+        {
+            newAddrs.emplace();
+            for (const auto& str : changeAs<ServerList>(name, value))
+            {
+                newAddrs->push_back(parseStaticAddr(str));
+            }
+        }
+        else
+        {
+            lg2::error("Unknown change {NAME}", "NAME", name);
+            elog<InvalidArgument>(Argument::ARGUMENT_NAME("Changes"),
+                                  Argument::ARGUMENT_VALUE(name.c_str()));
+        }
+    }
+
+    // The same updates the setters use, minus the write and reload
+    size_t changed = 0;
+    auto apply = [&](const auto& value, auto update) {
+        if (value)
+        {
+            changed += (this->*update)(*value);
+        }
+    };
+    apply(newDhcp4, &EthernetInterface::updateDHCP4);
+    apply(newDhcp6, &EthernetInterface::updateDHCP6);
+    apply(newRA, &EthernetInterface::updateIPv6AcceptRA);
+    apply(newNicEnabled, &EthernetInterface::updateNICEnabled);
+    apply(newGw4, &EthernetInterface::updateDefaultGateway);
+    apply(newGw6, &EthernetInterface::updateDefaultGateway6);
+    apply(newDns, &EthernetInterface::updateStaticNameServers);
+    apply(newNtp, &EthernetInterface::updateStaticNTPServers);
+    if (newAddrs)
+    {
+        std::vector<stdplus::SubnetAny> stale;
+        for (const auto& [ifaddr, addr] : addrs)
+        {
+            if (addr->origin() == IP::AddressOrigin::Static &&
+                std::find(newAddrs->begin(), newAddrs->end(), ifaddr) ==
+                    newAddrs->end())
+            {
+                stale.push_back(ifaddr);
+            }
+        }
+        for (const auto& ifaddr : stale)
+        {
+            changed += removeStaticAddr(ifaddr);
+        }
+        for (const auto& ifaddr : *newAddrs)
+        {
+            changed += std::get<1>(addStaticAddr(ifaddr));
+        }
+    }
+
+    auto applied = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    lg2::info("Applied {COUNT} of {TOTAL} changes to {NET_INTF} in {US}us",
+              "COUNT", changed, "TOTAL", changes.size(), "NET_INTF",
+              interfaceName(), "US", applied.count());
+    if (changed == 0)
+    {
+        return;
+    }
+
+    markConfigDirty();
+    manager.get().addReloadPostHook([start, ifname = interfaceName()]() {
+        auto total = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        lg2::info("Changes to {NET_INTF} took effect after {MS}ms", "NET_INTF",
+                  ifname, "MS", total.count());
+    });
+    manager.get().reloadConfigs();
+}
+
 EthernetInterface::VlanProperties::VlanProperties(
     sdbusplus::bus_t& bus, stdplus::const_zstring objPath,
     const InterfaceInfo& info, stdplus::PinnedRef<EthernetInterface> eth) :
@@ -1128,22 +1445,16 @@ void EthernetInterface::VlanProperties::delete_()
     std::error_code ec;
     std::filesystem::remove(config::pathForIntfConf(confDir, intf), ec);
     std::filesystem::remove(config::pathForIntfDev(confDir, intf), ec);
+    eth.get().manager.get().markNetdevChanged();
 
-    if (eth.get().ifIdx > 0)
-    {
-        eth.get().manager.get().interfacesByIdx.erase(eth.get().ifIdx);
-    }
-    auto it = eth.get().manager.get().interfaces.find(intf);
-    auto obj = std::move(it->second);
-    eth.get().manager.get().interfaces.erase(it);
+    // Keeps the object alive until we return
+    auto obj = eth.get().manager.get().eraseIntf(eth.get());
 
     // Write an updated parent interface since it has a VLAN entry
-    for (const auto& [_, intf] : eth.get().manager.get().interfaces)
+    if (auto parent = eth.get().manager.get().intfs.intf(parentIdx);
+        parent != nullptr)
     {
-        if (intf->ifIdx == parentIdx)
-        {
-            intf->writeConfigurationFile();
-        }
+        parent->markConfigDirty();
     }
 
     if (eth.get().ifIdx > 0)
@@ -1154,7 +1465,7 @@ void EthernetInterface::VlanProperties::delete_()
         });
 
         // Ignore the interface so the reload doesn't re-query it
-        eth.get().manager.get().ignoredIntf.emplace(eth.get().ifIdx);
+        eth.get().manager.get().ignoreIntf(eth.get().ifIdx);
     }
 
     eth.get().manager.get().reloadConfigs();
@@ -1164,8 +1475,7 @@ bool EthernetInterface::emitLLDP(bool value)
 {
     if (emitLLDP() != EthernetInterfaceIntf::emitLLDP(value))
     {
-        manager.get().writeLLDPDConfigurationFile();
-        manager.get().reloadLLDPService();
+        manager.get().setLLDPStatus(interfaceName());
     }
     return value;
 }
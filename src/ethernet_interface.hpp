@@ -7,9 +7,11 @@
 #include "xyz/openbmc_project/Network/IP/Create/server.hpp"
 #include "xyz/openbmc_project/Network/Neighbor/CreateStatic/server.hpp"
 #include "xyz/openbmc_project/Network/StaticGateway/Create/server.hpp"
+#include "xyz/openbmc_project/Network/Transaction/server.hpp"
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server/object.hpp>
+#include <stdplus/function_view.hpp>
 #include <stdplus/pinned.hpp>
 #include <stdplus/str/maps.hpp>
 #include <stdplus/zstring_view.hpp>
@@ -20,8 +22,11 @@
 #include <xyz/openbmc_project/Network/VLAN/server.hpp>
 #include <xyz/openbmc_project/Object/Delete/server.hpp>
 
+#include <map>
 #include <optional>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace phosphor
@@ -35,6 +40,7 @@ using Ifaces = sdbusplus::server::object_t<
     sdbusplus::xyz::openbmc_project::Network::IP::server::Create,
     sdbusplus::xyz::openbmc_project::Network::Neighbor::server::CreateStatic,
     sdbusplus::xyz::openbmc_project::Network::StaticGateway::server::Create,
+    sdbusplus::xyz::openbmc_project::Network::server::Transaction,
     sdbusplus::xyz::openbmc_project::Collection::server::DeleteAll>;
 
 using VlanIfaces = sdbusplus::server::object_t<
@@ -142,6 +148,14 @@ class EthernetInterface : public Ifaces
     ObjectPath staticGateway(std::string gateway,
                              IP::Protocol protocolType) override;
 
+    using Change = std::variant<bool, std::string, std::vector<std::string>>;
+
+    /** @brief Applies a set of property changes with a single configuration
+     *         write and reload.
+     *  @param[in] changes - The new values keyed by property name.
+     */
+    void applyChanges(std::map<std::string, Change> changes) override;
+
     /** Set value of DHCPEnabled */
     DHCPConf dhcpEnabled() const override;
     DHCPConf dhcpEnabled(DHCPConf value) override;
@@ -206,8 +220,31 @@ class EthernetInterface : public Ifaces
     ObjectPath createVLAN(uint16_t id);
 
     /** @brief write the network conf file with the in-memory objects.
+     *  @return Whether the file changed, writes that would not change what
+     *          networkd does are skipped
      */
-    void writeConfigurationFile();
+    bool writeConfigurationFile();
+
+    /** @brief Marks the network conf file as out of date. It is written
+     *         once by the next flush, at the latest right before networkd
+     *         is reloaded.
+     */
+    void markConfigDirty();
+
+    /** @brief Programs a change into the kernel right away when built with
+     *         apply-now, failures are logged and left to the networkd reload
+     *
+     *  @param[in] what  - What is being changed, for logging
+     *  @param[in] apply - Applies the change to the link with the given index
+     */
+    void applyNow(std::string_view what,
+                  stdplus::function_view<void(unsigned)> apply);
+
+    /** @brief Gets the number of times the network conf file was written */
+    inline size_t getConfigWrites() const noexcept
+    {
+        return configWrites;
+    }
 
     /** @brief delete all dbus objects.
      */
@@ -227,6 +264,12 @@ class EthernetInterface : public Ifaces
      */
     void reloadConfigs();
 
+    /** @brief Gets the kernel index, 0 until the link exists */
+    inline unsigned getIfIdx() const noexcept
+    {
+        return ifIdx;
+    }
+
     /** @brief set conf file for LLDP
      *  @param[in] value - lldp value of the interface.
      */
@@ -279,6 +322,41 @@ class EthernetInterface : public Ifaces
     friend class TestNetworkManager;
 
   private:
+    /** @brief Number of network conf file writes */
+    size_t configWrites = 0;
+
+    /** @brief Whether changes are programmed into the kernel right away,
+     *         as set by the apply-now option
+     */
+    bool applyNowEnabled;
+
+    /** @brief Makes an address static, creating its object if needed
+     *
+     *  @return The address object and whether anything changed
+     */
+    std::pair<IPAddress&, bool> addStaticAddr(stdplus::SubnetAny ifaddr);
+
+    /** @brief Drops a static address
+     *
+     *  @return Whether the address was static
+     */
+    bool removeStaticAddr(stdplus::SubnetAny ifaddr);
+
+    /** @brief Property updates shared by the setters and applyChanges. Each
+     *         runs every side effect of the change except the config write
+     *         and networkd reload, which the caller does or defers.
+     *
+     *  @return Whether the value changed
+     */
+    bool updateDHCP4(bool value);
+    bool updateDHCP6(bool value);
+    bool updateIPv6AcceptRA(bool value);
+    bool updateNICEnabled(bool value);
+    bool updateDefaultGateway(const std::string& gateway);
+    bool updateDefaultGateway6(const std::string& gateway);
+    bool updateStaticNameServers(const ServerList& value);
+    bool updateStaticNTPServers(const ServerList& value);
+
     EthernetInterface(stdplus::PinnedRef<sdbusplus::bus_t> bus,
                       stdplus::PinnedRef<Manager> manager,
                       const AllIntfInfo& info, std::string&& objPath,
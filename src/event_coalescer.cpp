@@ -0,0 +1,128 @@
+#include "event_coalescer.hpp"
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace phosphor::network::netlink
+{
+
+size_t EventCoalescer::KeyHash::operator()(const Key& key) const noexcept
+{
+    size_t ret = std::hash<decltype(key.obj)>{}(key.obj);
+    ret = ret * 31 + key.ifidx;
+    ret = ret * 31 + static_cast<size_t>(key.phase);
+    return ret * 31 + key.type;
+}
+
+EventCoalescer::Phase EventCoalescer::phaseOf(const Event& e) noexcept
+{
+    if (!std::holds_alternative<InterfaceInfo>(e.info))
+    {
+        return Phase::Object;
+    }
+    return e.add ? Phase::LinkAdd : Phase::LinkRemove;
+}
+
+EventCoalescer::Key EventCoalescer::keyOf(const Event& e) noexcept
+{
+    Key key{e.ifidx(), phaseOf(e), static_cast<uint8_t>(e.info.index()), {}};
+    std::visit(
+        [&](const auto& i) {
+            using T = std::decay_t<decltype(i)>;
+            if constexpr (std::is_same_v<T, AddressInfo>)
+            {
+                key.obj = i.ifaddr;
+            }
+            else if constexpr (std::is_same_v<T, NeighborInfo>)
+            {
+                if (i.addr)
+                {
+                    key.obj = *i.addr;
+                }
+            }
+            else if constexpr (std::is_same_v<T, DefGwInfo>)
+            {
+                key.obj = i.addr;
+            }
+        },
+        e.info);
+    return key;
+}
+
+void EventCoalescer::push(Event&& e)
+{
+    stats.pushed++;
+    auto key = keyOf(e);
+    if (key.phase == Phase::LinkRemove)
+    {
+        std::erase_if(index, [&](const auto& i) {
+            if (i.first.ifidx != key.ifidx)
+            {
+                return false;
+            }
+            events[i.second].reset();
+            return true;
+        });
+    }
+    auto [it, inserted] = index.try_emplace(std::move(key), events.size());
+    if (!inserted)
+    {
+        events[it->second].reset();
+        it->second = events.size();
+    }
+    events.emplace_back(std::move(e));
+    compact();
+}
+
+void EventCoalescer::compact()
+{
+    // Small buffers are not worth the rehashing
+    constexpr size_t minDead = 32;
+    const auto dead = events.size() - index.size();
+    if (dead < minDead || dead < index.size())
+    {
+        return;
+    }
+
+    size_t live = 0;
+    for (auto& e : events)
+    {
+        if (!e)
+        {
+            continue;
+        }
+        index.find(keyOf(*e))->second = live;
+        if (&events[live] != &e)
+        {
+            events[live] = std::move(e);
+        }
+        live++;
+    }
+    events.resize(live);
+}
+
+void EventCoalescer::flush(stdplus::function_view<void(const Event&)> apply)
+{
+    // Applying may re-enter and buffer new events, which wait for the next
+    // flush instead of invalidating this one
+    flushing.clear();
+    flushing.swap(events);
+    index.clear();
+    stats.flushes++;
+
+    for (auto phase : {Phase::LinkRemove, Phase::LinkAdd, Phase::Object})
+    {
+        for (const auto& e : flushing)
+        {
+            if (e && phaseOf(*e) == phase)
+            {
+                stats.applied++;
+                apply(*e);
+            }
+        }
+    }
+    flushing.clear();
+}
+
+} // namespace phosphor::network::netlink
@@ -0,0 +1,111 @@
+#pragma once
+#include "rtnetlink.hpp"
+
+#include <stdplus/function_view.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace phosphor::network::netlink
+{
+
+/** @class EventCoalescer
+ *  @brief Buffers rtnetlink events so each object is applied once per batch
+ *
+ *  @details Events are keyed by interface and object, only the last event
+ *           for a key is kept, so an add/remove/add sequence is applied as a
+ *           single add. Removing a link discards everything pending on it
+ *           since the kernel drops those objects along with the link.
+ *           Flushing applies link removals, then link additions, then all
+ *           other objects in the order of their last update, so objects
+ *           always land on an interface the manager knows about. The buffer
+ *           never holds much more than twice the pending events.
+ */
+class EventCoalescer
+{
+  public:
+    /** @brief Counters describing how much coalescing happened */
+    struct Stats
+    {
+        size_t pushed = 0;
+        size_t applied = 0;
+        size_t flushes = 0;
+    };
+
+    /** @brief Buffers an event, replacing any pending event for its object
+     *
+     *  @param[in] e - The event to buffer
+     */
+    void push(Event&& e);
+
+    /** @brief Applies every pending event and empties the buffer
+     *
+     *  @param[in] apply - Called for each surviving event
+     */
+    void flush(stdplus::function_view<void(const Event&)> apply);
+
+    /** @brief The number of events waiting to be applied */
+    inline size_t pending() const noexcept
+    {
+        return index.size();
+    }
+
+    /** @brief The number of buffered slots, including superseded events
+     *         that have not been compacted away yet
+     */
+    inline size_t buffered() const noexcept
+    {
+        return events.size();
+    }
+
+    /** @brief Gets the coalescing counters */
+    inline const Stats& getStats() const noexcept
+    {
+        return stats;
+    }
+
+  private:
+    /** @brief The flush phase an event belongs to */
+    enum class Phase : uint8_t
+    {
+        LinkRemove,
+        LinkAdd,
+        Object,
+    };
+
+    struct Key
+    {
+        unsigned ifidx;
+        Phase phase;
+        uint8_t type;
+        std::variant<std::monostate, stdplus::SubnetAny, stdplus::InAnyAddr>
+            obj;
+
+        bool operator==(const Key&) const noexcept = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const noexcept;
+    };
+
+    static Phase phaseOf(const Event& e) noexcept;
+    static Key keyOf(const Event& e) noexcept;
+
+    /** @brief Drops superseded slots once they outnumber the pending events,
+     *         so a flapping object can't grow the buffer without bound
+     */
+    void compact();
+
+    /** @brief Events in order of their last update, superseded ones empty */
+    std::vector<std::optional<Event>> events;
+    /** @brief The events being applied, kept to reuse its allocation */
+    std::vector<std::optional<Event>> flushing;
+    std::unordered_map<Key, size_t, KeyHash> index;
+    Stats stats;
+};
+
+} // namespace phosphor::network::netlink
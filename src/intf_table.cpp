@@ -0,0 +1,95 @@
+#include "intf_table.hpp"
+
+#include <algorithm>
+
+namespace phosphor::network
+{
+
+static bool inUse(const IntfTable::Slot& s) noexcept
+{
+    return s.intf != nullptr || s.info || s.enabled || s.ignored();
+}
+
+IntfTable::Slot* IntfTable::findSparse(unsigned ifidx) noexcept
+{
+    auto it = sparse.find(ifidx);
+    return it == sparse.end() ? nullptr : &it->second;
+}
+
+IntfTable::Slot& IntfTable::slot(unsigned ifidx)
+{
+    if (ifidx >= denseMax)
+    {
+        return sparse[ifidx];
+    }
+    if (ifidx >= slots.size())
+    {
+        slots.resize(ifidx + 1);
+    }
+    return slots[ifidx];
+}
+
+void IntfTable::setIgnored(unsigned ifidx, bool ignored)
+{
+    if (!ignored)
+    {
+        auto s = find(ifidx);
+        if (s == nullptr || !s->ignored_)
+        {
+            return;
+        }
+        s->ignored_ = false;
+    }
+    else
+    {
+        auto& s = slot(ifidx);
+        if (s.ignored_)
+        {
+            return;
+        }
+        s.ignored_ = true;
+    }
+    ignoredGeneration++;
+}
+
+std::vector<unsigned> IntfTable::ignoredIntfs() const
+{
+    std::vector<unsigned> ret;
+    for (unsigned i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i].ignored_)
+        {
+            ret.push_back(i);
+        }
+    }
+    auto dense = ret.size();
+    for (const auto& [ifidx, s] : sparse)
+    {
+        if (s.ignored_)
+        {
+            ret.push_back(ifidx);
+        }
+    }
+    std::sort(ret.begin() + dense, ret.end());
+    return ret;
+}
+
+void IntfTable::forEach(stdplus::function_view<void(unsigned, Slot&)> cb)
+{
+    for (unsigned i = 0; i < slots.size(); ++i)
+    {
+        if (inUse(slots[i]))
+        {
+            cb(i, slots[i]);
+        }
+    }
+    for (auto& [ifidx, s] : sparse)
+    {
+        if (inUse(s))
+        {
+            cb(ifidx, s);
+        }
+    }
+}
+
+} // namespace phosphor::network
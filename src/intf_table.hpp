@@ -0,0 +1,118 @@
+#pragma once
+#include "types.hpp"
+
+#include <stdplus/function_view.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace phosphor::network
+{
+
+class EthernetInterface;
+
+/** @class IntfTable
+ *  @brief Everything the manager tracks about an interface, in one slot per
+ *         ifindex
+ *
+ *  @details The kernel hands out small, mostly contiguous ifindexes, so the
+ *           slots live in a vector indexed by them and a netlink event costs
+ *           one bounds checked load instead of a hash lookup per map. The
+ *           large AllIntfInfo is kept out of line so slots stay packed and
+ *           so it does not move when the table grows. Indexes explicitly
+ *           assigned beyond the dense range fall back to a hash map.
+ */
+class IntfTable
+{
+  public:
+    /** @brief Ifindexes at or above this are kept in the sparse map */
+    static constexpr unsigned denseMax = 1u << 16;
+
+    struct Slot
+    {
+        /** @brief The object on the bus, null until it is created */
+        EthernetInterface* intf = nullptr;
+        /** @brief The kernel state, null until the link is announced */
+        std::unique_ptr<AllIntfInfo> info;
+        /** @brief Whether systemd-networkd manages the interface, unset
+         *         until it reports an administrative state
+         */
+        std::optional<bool> enabled;
+
+        /** @brief Whether events for the interface are dropped */
+        inline bool ignored() const noexcept
+        {
+            return ignored_;
+        }
+
+      private:
+        bool ignored_ = false;
+        friend class IntfTable;
+    };
+
+    /** @brief Gets the slot of an ifindex, nullptr if it was never used.
+     *         Pointers are invalidated by a later call to slot().
+     */
+    inline Slot* find(unsigned ifidx) noexcept
+    {
+        if (ifidx < slots.size())
+        {
+            return &slots[ifidx];
+        }
+        return ifidx < denseMax ? nullptr : findSparse(ifidx);
+    }
+    inline const Slot* find(unsigned ifidx) const noexcept
+    {
+        return const_cast<IntfTable*>(this)->find(ifidx);
+    }
+
+    /** @brief Gets the slot of an ifindex, growing the table as needed */
+    Slot& slot(unsigned ifidx);
+
+    /** @brief Gets the interface object, nullptr if there is none */
+    inline EthernetInterface* intf(unsigned ifidx) const noexcept
+    {
+        auto s = find(ifidx);
+        return s == nullptr ? nullptr : s->intf;
+    }
+
+    /** @brief Gets the kernel state, nullptr if the link is unknown */
+    inline AllIntfInfo* info(unsigned ifidx) noexcept
+    {
+        auto s = find(ifidx);
+        return s == nullptr ? nullptr : s->info.get();
+    }
+
+    inline bool ignored(unsigned ifidx) const noexcept
+    {
+        auto s = find(ifidx);
+        return s != nullptr && s->ignored_;
+    }
+
+    /** @brief Marks the interface as ignored or no longer ignored */
+    void setIgnored(unsigned ifidx, bool ignored);
+
+    /** @brief Changes whenever the set of ignored interfaces may have */
+    inline uint64_t getIgnoredGeneration() const noexcept
+    {
+        return ignoredGeneration;
+    }
+
+    /** @brief Gets the ignored ifindexes in ascending order */
+    std::vector<unsigned> ignoredIntfs() const;
+
+    /** @brief Calls back with every slot in use, dense ones first */
+    void forEach(stdplus::function_view<void(unsigned, Slot&)> cb);
+
+  private:
+    std::vector<Slot> slots;
+    std::unordered_map<unsigned, Slot> sparse;
+    uint64_t ignoredGeneration = 0;
+
+    Slot* findSparse(unsigned ifidx) noexcept;
+};
+
+} // namespace phosphor::network
@@ -2,6 +2,7 @@
 
 #include "ethernet_interface.hpp"
 #include "network_manager.hpp"
+#include "system_queries.hpp"
 #include "util.hpp"
 
 #include <phosphor-logging/elog-errors.hpp>
@@ -105,13 +106,16 @@ void IPAddress::delete_()
     {
         if (it->second.get() == this)
         {
+            parent.get().applyNow("address removal", [&](unsigned idx) {
+                system::deleteAddress(idx, it->first);
+            });
             ptr = std::move(it->second);
             addrs.erase(it);
             break;
         }
     }
 
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().manager.get().reloadConfigs();
 }
 
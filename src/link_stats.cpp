@@ -0,0 +1,101 @@
+#include "link_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace phosphor::network
+{
+
+LinkSample LinkSample::fromKernel(std::chrono::steady_clock::time_point time,
+                                  const rtnl_link_stats64& stats) noexcept
+{
+    return LinkSample{
+        .time = time,
+        .rxBytes = stats.rx_bytes,
+        .txBytes = stats.tx_bytes,
+        .rxPackets = stats.rx_packets,
+        .txPackets = stats.tx_packets,
+        .rxErrors = stats.rx_errors,
+        .txErrors = stats.tx_errors,
+        .rxDropped = stats.rx_dropped,
+        .txDropped = stats.tx_dropped,
+    };
+}
+
+/** @brief Whether any counter went backwards between two samples */
+static bool wrapped(const LinkSample& prev, const LinkSample& cur) noexcept
+{
+    return cur.rxBytes < prev.rxBytes || cur.txBytes < prev.txBytes ||
+           cur.rxPackets < prev.rxPackets || cur.txPackets < prev.txPackets ||
+           cur.rxErrors < prev.rxErrors || cur.txErrors < prev.txErrors ||
+           cur.rxDropped < prev.rxDropped || cur.txDropped < prev.txDropped;
+}
+
+void LinkStatsTable::History::forEach(
+    stdplus::function_view<void(const LinkSample&)> cb) const
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        cb(samples[(next + historyLen - count + i) % historyLen]);
+    }
+}
+
+void LinkStatsTable::record(unsigned ifidx, const LinkSample& sample)
+{
+    auto& h = links[ifidx];
+    h.seen = true;
+    if (h.count > 0)
+    {
+        const auto& prev = h.latest();
+        std::chrono::duration<double> dt = sample.time - prev.time;
+        if (wrapped(prev, sample))
+        {
+            h.rates = {};
+            h.primed = false;
+        }
+        else if (dt.count() > 0)
+        {
+            // Weighting by elapsed time keeps late samples from skewing
+            // the averages when the event loop was busy
+            double alpha = h.primed ? 1 - std::exp(-dt / tau) : 1;
+            auto update = [&](double& rate, uint64_t cur, uint64_t old) {
+                rate += alpha * ((cur - old) / dt.count() - rate);
+            };
+            update(h.rates.rxBytes, sample.rxBytes, prev.rxBytes);
+            update(h.rates.txBytes, sample.txBytes, prev.txBytes);
+            update(h.rates.rxErrors, sample.rxErrors, prev.rxErrors);
+            update(h.rates.txErrors, sample.txErrors, prev.txErrors);
+            h.primed = true;
+        }
+    }
+    h.samples[h.next] = sample;
+    h.next = (h.next + 1) % historyLen;
+    h.count = std::min(h.count + 1, historyLen);
+}
+
+void LinkStatsTable::prune()
+{
+    std::erase_if(links, [](const auto& e) { return !e.second.seen; });
+    for (auto& [_, h] : links)
+    {
+        h.seen = false;
+    }
+}
+
+const LinkStatsTable::History* LinkStatsTable::get(
+    unsigned ifidx) const noexcept
+{
+    auto it = links.find(ifidx);
+    return it == links.end() ? nullptr : &it->second;
+}
+
+void LinkStatsTable::forEach(
+    stdplus::function_view<void(unsigned, const History&)> cb) const
+{
+    for (const auto& [ifidx, h] : links)
+    {
+        cb(ifidx, h);
+    }
+}
+
+} // namespace phosphor::network
@@ -0,0 +1,107 @@
+#pragma once
+#include <linux/if_link.h>
+
+#include <stdplus/function_view.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+namespace phosphor::network
+{
+
+/** @brief The link counters read at one point in time */
+struct LinkSample
+{
+    std::chrono::steady_clock::time_point time;
+    uint64_t rxBytes;
+    uint64_t txBytes;
+    uint64_t rxPackets;
+    uint64_t txPackets;
+    uint64_t rxErrors;
+    uint64_t txErrors;
+    uint64_t rxDropped;
+    uint64_t txDropped;
+
+    static LinkSample fromKernel(std::chrono::steady_clock::time_point time,
+                                 const rtnl_link_stats64& stats) noexcept;
+};
+
+/** @brief Per second rates smoothed with an exponentially weighted moving
+ *         average
+ */
+struct LinkRates
+{
+    double rxBytes = 0;
+    double txBytes = 0;
+    double rxErrors = 0;
+    double txErrors = 0;
+};
+
+/** @class LinkStatsTable
+ *  @brief Keeps a fixed number of recent samples for every link along with
+ *         the smoothed rates derived from them
+ *
+ *  @details Each link owns a ring of samples allocated when the link is
+ *           first seen, so recording a sample never allocates.
+ */
+class LinkStatsTable
+{
+  public:
+    static constexpr size_t historyLen = 60;
+
+    struct History
+    {
+        std::array<LinkSample, historyLen> samples;
+        /** @brief Where the next sample goes */
+        size_t next = 0;
+        size_t count = 0;
+        LinkRates rates = {};
+        /** @brief Whether the rates are based on at least one interval */
+        bool primed = false;
+        /** @brief Whether the link was sampled since the last prune */
+        bool seen = false;
+
+        /** @brief The most recent sample, only valid if count > 0 */
+        inline const LinkSample& latest() const noexcept
+        {
+            return samples[(next + historyLen - 1) % historyLen];
+        }
+
+        /** @brief Calls back with the samples from oldest to newest */
+        void forEach(stdplus::function_view<void(const LinkSample&)> cb) const;
+    };
+
+    /** @brief Constructor
+     *
+     *  @param[in] tau - The time constant of the moving averages, a sample
+     *                   older than this weighs ~37% of a fresh one
+     */
+    explicit LinkStatsTable(std::chrono::nanoseconds tau) : tau(tau) {}
+
+    /** @brief Records a sample, counters going backwards, as when a driver
+     *         is reloaded, restart the rates from the next interval
+     */
+    void record(unsigned ifidx, const LinkSample& sample);
+
+    /** @brief Forgets the links not recorded since the last prune */
+    void prune();
+
+    /** @brief Gets the history of a link, nullptr if it was never sampled */
+    const History* get(unsigned ifidx) const noexcept;
+
+    void forEach(
+        stdplus::function_view<void(unsigned, const History&)> cb) const;
+
+    inline size_t size() const noexcept
+    {
+        return links.size();
+    }
+
+  private:
+    std::chrono::nanoseconds tau;
+    std::unordered_map<unsigned, History> links;
+};
+
+} // namespace phosphor::network
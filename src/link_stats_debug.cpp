@@ -0,0 +1,108 @@
+#include "link_stats_debug.hpp"
+
+#include "network_manager.hpp"
+#include "rtnetlink.hpp"
+
+#include <linux/rtnetlink.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <system_error>
+
+namespace phosphor
+{
+namespace network
+{
+
+/** @brief The averages follow traffic changes over a few samples */
+constexpr unsigned ewmaSamples = 4;
+
+LinkStatsDebug::LinkStatsDebug(sdbusplus::bus_t& bus,
+                               stdplus::zstring_view objPath,
+                               sdeventplus::Event& event,
+                               std::chrono::milliseconds interval,
+                               const Manager& manager) :
+    LinkStatsDebugObj(bus, objPath.c_str(),
+                      LinkStatsDebugObj::action::emit_interface_added),
+    manager(manager), interval(interval), table(interval * ewmaSamples),
+    requester(event, NETLINK_ROUTE), timer(event, [this](auto&) { sample(); })
+{
+    sample();
+}
+
+void LinkStatsDebug::sample()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto msgCb = [this, now](const nlmsghdr& hdr, std::string_view data) {
+        if (hdr.nlmsg_type != RTM_NEWLINK)
+        {
+            return;
+        }
+        if (auto stats = netlink::statsFromRtm(data); stats)
+        {
+            auto [ifidx, counters] = *stats;
+            table.record(ifidx, LinkSample::fromKernel(now, counters));
+        }
+    };
+    auto doneCb = [this](int err) {
+        if (err == 0)
+        {
+            // Only a complete dump tells which links are gone
+            table.prune();
+        }
+        else
+        {
+            lg2::error("Failed sampling link stats: {ERROR}", "ERROR",
+                       std::system_category().message(err));
+        }
+        timer.restartOnce(interval);
+    };
+    try
+    {
+        requester.request(RTM_GETLINK, NLM_F_DUMP, ifinfomsg{}, interval,
+                          std::move(msgCb), std::move(doneCb));
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed sampling link stats: {ERROR}", "ERROR", e);
+        timer.restartOnce(interval);
+    }
+}
+
+std::map<std::string, LinkStatsDebug::Link> LinkStatsDebug::get()
+{
+    // Samples are taken on the monotonic clock, clients want wall time
+    auto steadyNow = std::chrono::steady_clock::now();
+    auto wallNow = std::chrono::system_clock::now();
+    auto toWallMs = [&](std::chrono::steady_clock::time_point t) {
+        auto wall = wallNow - (steadyNow - t);
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                wall.time_since_epoch())
+                .count());
+    };
+
+    std::map<std::string, Link> ret;
+    table.forEach([&](unsigned ifidx, const LinkStatsTable::History& h) {
+        auto intf = manager.intfs.intf(ifidx);
+        if (intf == nullptr)
+        {
+            // Ignored or not yet known interfaces have no name to report
+            return;
+        }
+        std::vector<Sample> samples;
+        samples.reserve(h.count);
+        h.forEach([&](const LinkSample& s) {
+            samples.emplace_back(toWallMs(s.time), s.rxBytes, s.txBytes,
+                                 s.rxPackets, s.txPackets, s.rxErrors,
+                                 s.txErrors, s.rxDropped, s.txDropped);
+        });
+        ret.emplace(intf->interfaceName(),
+                    Link(h.rates.rxBytes, h.rates.txBytes, h.rates.rxErrors,
+                         h.rates.txErrors, std::move(samples)));
+    });
+    return ret;
+}
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,71 @@
+#pragma once
+#include "link_stats.hpp"
+#include "netlink_async.hpp"
+#include "xyz/openbmc_project/Network/Debug/LinkStats/server.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/object.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+#include <stdplus/zstring_view.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor
+{
+namespace network
+{
+
+class Manager;
+
+using LinkStatsDebugIntf =
+    sdbusplus::xyz::openbmc_project::Network::Debug::server::LinkStats;
+
+using LinkStatsDebugObj = sdbusplus::server::object_t<LinkStatsDebugIntf>;
+
+/** @class LinkStatsDebug
+ *  @brief Samples the counters of every link and serves them on D-Bus.
+ *  @details Each round is a single asynchronous RTM_GETLINK dump, and the
+ *           next round is only scheduled once the previous one finished, so
+ *           a slow reply never stacks up requests.
+ */
+class LinkStatsDebug : public LinkStatsDebugObj
+{
+  public:
+    using Sample = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t,
+                              uint64_t, uint64_t, uint64_t, uint64_t,
+                              uint64_t>;
+    using Link =
+        std::tuple<double, double, double, double, std::vector<Sample>>;
+
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] objPath - Path to attach at.
+     *  @param[in] event - Runs the sampling.
+     *  @param[in] interval - The time between two samples.
+     *  @param[in] manager - Resolves interface names.
+     */
+    LinkStatsDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+                   sdeventplus::Event& event,
+                   std::chrono::milliseconds interval, const Manager& manager);
+
+    std::map<std::string, Link> get() override;
+
+  private:
+    const Manager& manager;
+    std::chrono::milliseconds interval;
+    LinkStatsTable table;
+    netlink::AsyncRequester requester;
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
+    /** @brief Starts a sampling round */
+    void sample();
+};
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,102 @@
+#include "lldp_control.hpp"
+
+#include "util.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace network
+{
+
+constexpr auto lldpcliPath = "/usr/sbin/lldpcli";
+/** @brief How long lldpcli may block the event loop before it is killed */
+constexpr auto lldpcliTimeout = std::chrono::seconds(2);
+
+static std::string_view lldpStatus(bool emit)
+{
+    return emit ? "tx-only" : "disabled";
+}
+
+LLDPControl::LLDPControl(std::filesystem::path confPath, Runner&& runner,
+                         Restarter&& restarter) :
+    confPath(std::move(confPath)), runner(std::move(runner)),
+    restarter(std::move(restarter))
+{}
+
+int LLDPControl::lldpcli(const std::vector<std::string>& args)
+{
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>("lldpcli"));
+    for (const auto& arg : args)
+    {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    return internal::executeCommandinChildProcess(lldpcliPath, argv.data(),
+                                                  lldpcliTimeout);
+}
+
+void LLDPControl::apply(const std::map<std::string, bool>& ports,
+                        std::string_view changed)
+{
+    persist(ports);
+    auto it = ports.find(std::string(changed));
+    if (it == ports.end())
+    {
+        restarter();
+        return;
+    }
+    try
+    {
+        int ret = runner({"configure", "ports", it->first, "lldp", "status",
+                          std::string(lldpStatus(it->second))});
+        if (ret != 0)
+        {
+            throw std::runtime_error(
+                std::format("lldpcli exited with {}", ret));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to configure LLDP on {NAME}, restarting lldpd: "
+                   "{ERROR}",
+                   "NAME", changed, "ERROR", e);
+        restarter();
+    }
+}
+
+void LLDPControl::persist(const std::map<std::string, bool>& ports) const
+{
+    std::string conf = "configure system description BMC\n"
+                       "configure system ip management pattern eth*\n";
+    for (const auto& [name, emit] : ports)
+    {
+        conf += "configure ports ";
+        conf += name;
+        conf += " lldp status ";
+        conf += lldpStatus(emit);
+        conf += '\n';
+    }
+    std::ofstream file;
+    file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    try
+    {
+        file.open(confPath);
+        file.write(conf.data(), conf.size());
+        file.close();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to write {FILE}: {ERROR}", "FILE", confPath,
+                   "ERROR", e);
+    }
+}
+
+} // namespace network
+} // namespace phosphor
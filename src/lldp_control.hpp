@@ -0,0 +1,75 @@
+#pragma once
+#include <function2/function2.hpp>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace phosphor
+{
+namespace network
+{
+
+/** @class LLDPControl
+ *  @brief Applies per port LLDP changes to a running lldpd
+ *
+ *  @details Every change is persisted to the lldpd configuration file so
+ *           it survives lldpd restarts, and applied to the port alone
+ *           through lldpcli, keeping the LLDP state of every other port.
+ *           lldpd is only restarted to reload the whole file when lldpcli
+ *           fails.
+ */
+class LLDPControl
+{
+  public:
+    /** @brief Runs lldpcli with the given arguments
+     *
+     *  @return The exit status of lldpcli
+     */
+    using Runner = fu2::unique_function<int(const std::vector<std::string>&)>;
+
+    /** @brief Restarts lldpd */
+    using Restarter = fu2::unique_function<void()>;
+
+    /** @brief Constructor
+     *
+     *  @param[in] confPath - The lldpd configuration file
+     *  @param[in] runner - Runs lldpcli commands
+     *  @param[in] restarter - Restarts lldpd
+     */
+    LLDPControl(std::filesystem::path confPath, Runner&& runner,
+                Restarter&& restarter);
+
+    /** @brief Runs the installed lldpcli and waits a bounded time for it
+     *         to exit, killing it afterwards
+     *
+     *  @param[in] args - The arguments following the program name
+     *  @return The exit status of lldpcli, 255 if it could not be executed
+     *  @throws If lldpcli did not exit in time
+     */
+    static int lldpcli(const std::vector<std::string>& args);
+
+    /** @brief Applies the new status of a port and persists all of them
+     *
+     *  @param[in] ports - The LLDP status of every port, true to transmit
+     *  @param[in] changed - The port whose status changed
+     */
+    void apply(const std::map<std::string, bool>& ports,
+               std::string_view changed);
+
+    /** @brief Writes the configuration file with the status of every port
+     *
+     *  @param[in] ports - The LLDP status of every port, true to transmit
+     */
+    void persist(const std::map<std::string, bool>& ports) const;
+
+  private:
+    std::filesystem::path confPath;
+    Runner runner;
+    Restarter restarter;
+};
+
+} // namespace network
+} // namespace phosphor
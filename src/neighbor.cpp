@@ -2,6 +2,7 @@
 
 #include "ethernet_interface.hpp"
 #include "network_manager.hpp"
+#include "system_queries.hpp"
 
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
@@ -51,13 +52,16 @@ void Neighbor::delete_()
     {
         if (it->second.get() == this)
         {
+            parent.get().applyNow("neighbor removal", [&](unsigned idx) {
+                system::deleteNeighbor(idx, it->first);
+            });
             ptr = std::move(it->second);
             neighbors.erase(it);
             break;
         }
     }
 
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().manager.get().reloadConfigs();
 }
 
@@ -0,0 +1,92 @@
+#include "neighbor_debug.hpp"
+
+#include "network_manager.hpp"
+
+#include <phosphor-logging/elog-errors.hpp>
+#include <stdplus/net/addr/ether.hpp>
+#include <stdplus/net/addr/ip.hpp>
+#include <xyz/openbmc_project/Common/error.hpp>
+
+namespace phosphor
+{
+namespace network
+{
+
+using namespace phosphor::logging;
+using namespace sdbusplus::xyz::openbmc_project::Common::Error;
+
+NeighborDebug::NeighborDebug(sdbusplus::bus_t& bus,
+                             stdplus::zstring_view objPath,
+                             sdeventplus::Event& event, NeighborTable& neighs,
+                             const Manager& manager) :
+    NeighborDebugObj(bus, objPath.c_str(),
+                     NeighborDebugObj::action::emit_interface_added),
+    neighs(neighs), manager(manager),
+    timer(event, [this](auto&) { publish(); })
+{
+    NeighborDebugIntf::generation(neighs.getGeneration(), true);
+    neighs.setNotify([this]() { changed(); });
+}
+
+NeighborDebug::~NeighborDebug()
+{
+    neighs.setNotify(nullptr);
+}
+
+void NeighborDebug::changed()
+{
+    if (timer.isEnabled())
+    {
+        // Already deferred, the timer picks up this change too
+        return;
+    }
+    auto next = lastNotify + notifyInterval;
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next)
+    {
+        publish();
+        return;
+    }
+    timer.restartOnce(std::chrono::ceil<std::chrono::microseconds>(next - now));
+}
+
+void NeighborDebug::publish()
+{
+    lastNotify = std::chrono::steady_clock::now();
+    NeighborDebugIntf::generation(neighs.getGeneration());
+}
+
+std::vector<NeighborDebug::Neighbor>
+    NeighborDebug::list(std::string interface)
+{
+    auto name = [&](unsigned ifidx) -> std::string {
+        auto intf = manager.intfs.intf(ifidx);
+        return intf == nullptr ? std::string() : intf->interfaceName();
+    };
+
+    unsigned ifidx = 0;
+    if (!interface.empty())
+    {
+        // Interfaces not yet created by the kernel have no index
+        auto it = manager.interfaces.find(interface);
+        if (it == manager.interfaces.end() || it->second->getIfIdx() == 0)
+        {
+            using ResourceErr = phosphor::logging::xyz::openbmc_project::
+                Common::ResourceNotFound;
+            elog<ResourceNotFound>(ResourceErr::RESOURCE(interface.c_str()));
+        }
+        ifidx = it->second->getIfIdx();
+    }
+
+    std::vector<Neighbor> ret;
+    ret.reserve(ifidx == 0 ? neighs.size() : 0);
+    neighs.forEach(ifidx, [&](const NeighborInfo& info) {
+        ret.emplace_back(name(info.ifidx), stdplus::toStr(*info.addr),
+                         info.mac ? stdplus::toStr(*info.mac) : "",
+                         info.state);
+    });
+    return ret;
+}
+
+} // namespace network
+} // namespace phosphor
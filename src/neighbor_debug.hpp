@@ -0,0 +1,70 @@
+#pragma once
+#include "neighbor_table.hpp"
+#include "xyz/openbmc_project/Network/Debug/Neighbors/server.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/object.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+#include <stdplus/zstring_view.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor
+{
+namespace network
+{
+
+class Manager;
+
+using NeighborDebugIntf =
+    sdbusplus::xyz::openbmc_project::Network::Debug::server::Neighbors;
+
+using NeighborDebugObj = sdbusplus::server::object_t<NeighborDebugIntf>;
+
+/** @class NeighborDebug
+ *  @brief Lists the mirrored neighbor cache on D-Bus.
+ *  @details Changes bump the Generation property no more than once per
+ *           notifyInterval, so a flapping neighbor cache doesn't flood the
+ *           bus with signals.
+ */
+class NeighborDebug : public NeighborDebugObj
+{
+  public:
+    using Neighbor =
+        std::tuple<std::string, std::string, std::string, uint16_t>;
+
+    /** @brief The minimum time between two Generation changes */
+    static constexpr std::chrono::seconds notifyInterval{1};
+
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] objPath - Path to attach at.
+     *  @param[in] event - Runs the deferred notifications.
+     *  @param[in] neighs - The mirrored neighbors.
+     *  @param[in] manager - Resolves interface names.
+     */
+    NeighborDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+                  sdeventplus::Event& event, NeighborTable& neighs,
+                  const Manager& manager);
+    ~NeighborDebug();
+
+    std::vector<Neighbor> list(std::string interface) override;
+
+  private:
+    NeighborTable& neighs;
+    const Manager& manager;
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+    std::chrono::steady_clock::time_point lastNotify;
+
+    /** @brief Publishes a change now or once the interval has passed */
+    void changed();
+    void publish();
+};
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,160 @@
+#include "neighbor_table.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace phosphor::network
+{
+
+static bool keyLess(const auto& a, const auto& b) noexcept
+{
+    return std::tie(a.ifidx, a.family, a.addr) <
+           std::tie(b.ifidx, b.family, b.addr);
+}
+
+NeighborTable::Entry NeighborTable::toEntry(const NeighborInfo& info)
+{
+    if (!info.addr)
+    {
+        throw std::invalid_argument("Neighbor without address");
+    }
+    Entry ret = {};
+    ret.ifidx = info.ifidx;
+    ret.state = info.state;
+    std::visit(
+        [&](const auto& addr) {
+            using T = std::decay_t<decltype(addr)>;
+            ret.family = std::is_same_v<T, stdplus::In4Addr> ? AF_INET
+                                                             : AF_INET6;
+            static_assert(sizeof(addr) <= sizeof(ret.addr));
+            std::memcpy(ret.addr.data(), &addr, sizeof(addr));
+        },
+        *info.addr);
+    if (info.mac)
+    {
+        ret.hasMac = true;
+        ret.mac = *info.mac;
+    }
+    return ret;
+}
+
+std::vector<NeighborTable::Entry>::iterator
+    NeighborTable::find(const Entry& entry)
+{
+    return std::lower_bound(
+        entries.begin(), entries.end(), entry,
+        [](const Entry& a, const Entry& b) { return keyLess(a, b); });
+}
+
+void NeighborTable::changed()
+{
+    generation++;
+    if (notify)
+    {
+        notify();
+    }
+}
+
+bool NeighborTable::update(const NeighborInfo& info)
+{
+    auto entry = toEntry(info);
+    auto it = find(entry);
+    if (it != entries.end() && !keyLess(entry, *it))
+    {
+        if (*it == entry)
+        {
+            return false;
+        }
+        *it = entry;
+    }
+    else
+    {
+        entries.insert(it, entry);
+    }
+    changed();
+    return true;
+}
+
+bool NeighborTable::remove(const NeighborInfo& info)
+{
+    auto entry = toEntry(info);
+    auto it = find(entry);
+    if (it == entries.end() || keyLess(entry, *it))
+    {
+        return false;
+    }
+    entries.erase(it);
+    changed();
+    return true;
+}
+
+size_t NeighborTable::removeIntf(unsigned ifidx)
+{
+    auto first = std::partition_point(
+        entries.begin(), entries.end(),
+        [&](const Entry& e) { return e.ifidx < ifidx; });
+    auto last = std::partition_point(
+        first, entries.end(), [&](const Entry& e) { return e.ifidx == ifidx; });
+    size_t ret = last - first;
+    if (ret > 0)
+    {
+        entries.erase(first, last);
+        changed();
+    }
+    return ret;
+}
+
+void NeighborTable::assign(NeighborTable&& other)
+{
+    if (entries == other.entries)
+    {
+        return;
+    }
+    entries = std::move(other.entries);
+    changed();
+}
+
+void NeighborTable::forEach(
+    unsigned ifidx, stdplus::function_view<void(const NeighborInfo&)> cb) const
+{
+    auto it = entries.begin();
+    if (ifidx != 0)
+    {
+        it = std::partition_point(
+            entries.begin(), entries.end(),
+            [&](const Entry& e) { return e.ifidx < ifidx; });
+    }
+    for (; it != entries.end() && (ifidx == 0 || it->ifidx == ifidx); ++it)
+    {
+        NeighborInfo info{.ifidx = it->ifidx,
+                          .state = it->state,
+                          .addr = std::nullopt,
+                          .mac = std::nullopt};
+        if (it->family == AF_INET)
+        {
+            in_addr addr;
+            std::memcpy(&addr, it->addr.data(), sizeof(addr));
+            info.addr.emplace(stdplus::In4Addr(addr));
+        }
+        else
+        {
+            in6_addr addr;
+            std::memcpy(&addr, it->addr.data(), sizeof(addr));
+            info.addr.emplace(stdplus::In6Addr(addr));
+        }
+        if (it->hasMac)
+        {
+            info.mac.emplace(it->mac);
+        }
+        cb(info);
+    }
+}
+
+} // namespace phosphor::network
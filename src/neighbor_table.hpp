@@ -0,0 +1,99 @@
+#pragma once
+#include "types.hpp"
+
+#include <function2/function2.hpp>
+#include <stdplus/function_view.hpp>
+#include <stdplus/net/addr/ether.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace phosphor::network
+{
+
+/** @class NeighborTable
+ *  @brief A mirror of the kernel neighbor cache in every state, not only
+ *         the permanent entries the manager configures
+ *
+ *  @details Entries are kept in a single vector sorted by interface and
+ *           address, so the neighbors of one interface are contiguous and
+ *           listing them touches no other memory. Each entry stores the
+ *           address as raw bytes to keep it small and trivially copyable.
+ */
+class NeighborTable
+{
+  public:
+    /** @brief Adds or updates a neighbor
+     *
+     *  @return True if the table changed
+     */
+    bool update(const NeighborInfo& info);
+
+    /** @brief Removes a neighbor
+     *
+     *  @return True if the table changed
+     */
+    bool remove(const NeighborInfo& info);
+
+    /** @brief Removes every neighbor of an interface
+     *
+     *  @return The number of neighbors removed
+     */
+    size_t removeIntf(unsigned ifidx);
+
+    /** @brief Takes over the entries of another table, as when the kernel
+     *         state was re-dumped, keeping the notifier of this one
+     */
+    void assign(NeighborTable&& other);
+
+    /** @brief Calls back with the neighbors of an interface, ordered by
+     *         address
+     *
+     *  @param[in] ifidx - The interface, or 0 for every interface
+     */
+    void forEach(unsigned ifidx,
+                 stdplus::function_view<void(const NeighborInfo&)> cb) const;
+
+    inline size_t size() const noexcept
+    {
+        return entries.size();
+    }
+
+    /** @brief A counter which increases on every change */
+    inline uint64_t getGeneration() const noexcept
+    {
+        return generation;
+    }
+
+    /** @brief Sets a callback run after every change, it is up to the
+     *         callback to limit how often anyone else is told
+     */
+    inline void setNotify(fu2::unique_function<void()>&& cb)
+    {
+        notify = std::move(cb);
+    }
+
+  private:
+    struct Entry
+    {
+        uint32_t ifidx;
+        uint8_t family;
+        bool hasMac;
+        uint16_t state;
+        std::array<uint8_t, 16> addr;
+        stdplus::EtherAddr mac;
+
+        bool operator==(const Entry&) const noexcept = default;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t generation = 0;
+    fu2::unique_function<void()> notify;
+
+    static Entry toEntry(const NeighborInfo& info);
+    std::vector<Entry>::iterator find(const Entry& entry);
+    void changed();
+};
+
+} // namespace phosphor::network
@@ -2,15 +2,24 @@
 
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <poll.h>
+#include <sys/socket.h>
 
+#include <phosphor-logging/lg2.hpp>
 #include <stdplus/fd/create.hpp>
 #include <stdplus/fd/ops.hpp>
 #include <stdplus/raw.hpp>
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstring>
 #include <format>
+#include <span>
 #include <stdexcept>
 #include <system_error>
+#include <unordered_map>
+#include <vector>
 
 using stdplus::raw::Aligned;
 
@@ -65,7 +74,7 @@ void processMsg(std::string_view& msgs, bool& done, ReceiveCallback cb)
     {
         const auto& err = stdplus::raw::refFrom<nlmsgerr, Aligned>(msg);
         // This is just an ACK so don't do the callback
-        if (err.error <= 0)
+        if (err.error == 0)
         {
             doCallback = false;
         }
@@ -103,6 +112,58 @@ static void requestSend(int sock, void* data, size_t size)
     }
 }
 
+static ssize_t recvDatagram(int sock, std::span<char> buf)
+{
+    iovec iov{};
+    iov.iov_base = buf.data();
+    iov.iov_len = buf.size();
+
+    sockaddr_nl from{};
+    from.nl_family = AF_NETLINK;
+
+    msghdr hdr{};
+    hdr.msg_name = &from;
+    hdr.msg_namelen = sizeof(from);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+
+    ssize_t recvd = recvmsg(sock, &hdr, 0);
+    if (recvd < 0 && errno != EAGAIN)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "netlink recvmsg");
+    }
+    return recvd;
+}
+
+/** @brief Probes the size of the next datagram without consuming it
+ *
+ *  @param[in] sock - The socket to probe
+ *  @return The full length of the datagram, or -1 with errno set to EAGAIN
+ *          if none is queued or ENOBUFS if the socket overran
+ */
+static ssize_t peekDatagram(int sock)
+{
+    sockaddr_nl from{};
+    from.nl_family = AF_NETLINK;
+
+    iovec iov{};
+
+    msghdr hdr{};
+    hdr.msg_name = &from;
+    hdr.msg_namelen = sizeof(from);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+
+    ssize_t recvd = recvmsg(sock, &hdr, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+    if (recvd < 0 && errno != EAGAIN && errno != ENOBUFS)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "netlink recvmsg");
+    }
+    return recvd;
+}
+
 static stdplus::ManagedFd makeSocket(int protocol)
 {
     using namespace stdplus::fd;
@@ -110,6 +171,12 @@ static stdplus::ManagedFd makeSocket(int protocol)
     auto sock = socket(SocketDomain::Netlink, SocketType::Raw,
                        static_cast<stdplus::fd::SocketProto>(protocol));
 
+    // Lets dumps be filtered by the kernel, kernels without support return
+    // unfiltered dumps instead so the failure is harmless
+    int strict = 1;
+    setsockopt(sock.get(), SOL_NETLINK, NETLINK_GET_STRICT_CHK, &strict,
+               sizeof(strict));
+
     sockaddr_nl local{};
     local.nl_family = AF_NETLINK;
     bind(sock, local);
@@ -117,45 +184,370 @@ static stdplus::ManagedFd makeSocket(int protocol)
     return sock;
 }
 
-void performRequest(int protocol, void* data, size_t size, ReceiveCallback cb)
+/** @brief Idle request sockets kept open between requests, keyed by protocol
+ */
+static std::unordered_map<int, std::vector<stdplus::ManagedFd>> sockPool;
+
+/** @brief Sequence number for the next request, shared by all sockets so a
+ *         reply can never be mistaken for one belonging to another request.
+ */
+static uint32_t nextSeq = 1;
+
+PooledSocket::PooledSocket(int protocol) : protocol(protocol)
+{
+    auto& idle = sockPool[protocol];
+    if (idle.empty())
+    {
+        sock = makeSocket(protocol);
+    }
+    else
+    {
+        sock = std::move(idle.back());
+        idle.pop_back();
+    }
+}
+
+PooledSocket::~PooledSocket()
+{
+    // A request that failed part way through may have left replies queued
+    // on the socket, so only clean sockets are handed out again.
+    if (reusable)
+    {
+        sockPool[protocol].push_back(std::move(sock));
+    }
+}
+
+/** @brief Stamps every message of a request with a fresh sequence number
+ *
+ *  @return The sequence number assigned to the request
+ */
+static uint32_t stampSeq(void* data, size_t size)
 {
-    auto sock = makeSocket(protocol);
+    // Batched messages share the sequence number and are told apart by the
+    // order of their replies
+    const auto seq = nextSeq++;
+    for (size_t off = 0; off + sizeof(nlmsghdr) <= size;)
+    {
+        auto& hdr = *reinterpret_cast<nlmsghdr*>(
+            reinterpret_cast<char*>(data) + off);
+        hdr.nlmsg_seq = seq;
+        if (hdr.nlmsg_len < sizeof(hdr))
+        {
+            break;
+        }
+        off += NLMSG_ALIGN(hdr.nlmsg_len);
+    }
+    return seq;
+}
+
+uint32_t PooledSocket::send(void* data, size_t size)
+{
+    const auto seq = stampSeq(data, size);
     requestSend(sock.get(), data, size);
-    receive(sock.get(), cb);
+    return seq;
+}
+
+/** @brief Drops the leading message if it is not a reply to seq
+ *
+ *  @param[in,out] msgs - The buffer holding nlmsgs to parse
+ *  @param[in] seq      - The sequence number of the outstanding request
+ *  @return True if a stale message was skipped
+ */
+static bool skipStale(std::string_view& msgs, uint32_t seq)
+{
+    const auto& hdr = stdplus::raw::refFrom<nlmsghdr, Aligned>(msgs);
+    if (hdr.nlmsg_seq == seq || hdr.nlmsg_len < sizeof(hdr) ||
+        msgs.size() < hdr.nlmsg_len)
+    {
+        // Malformed messages are left for processMsg() to reject
+        return false;
+    }
+    msgs.remove_prefix(
+        std::min<size_t>(NLMSG_ALIGN(hdr.nlmsg_len), msgs.size()));
+    return true;
+}
+
+size_t PooledSocket::receive(uint32_t seq, ReceiveCallback cb, size_t replies)
+{
+    std::array<char, 8192> buf;
+
+    // Replies to requests abandoned on this socket are discarded by sequence
+    // number until everything belonging to seq has been seen.
+    bool done = true;
+    size_t num_msgs = 0;
+    do
+    {
+        ssize_t recvd = recvDatagram(sock.get(), buf);
+        if (recvd <= 0)
+        {
+            throw std::runtime_error("netlink recvmsg: Got empty payload");
+        }
+
+        std::string_view msgs(buf.data(), recvd);
+        while (!msgs.empty() && replies > 0)
+        {
+            if (skipStale(msgs, seq))
+            {
+                continue;
+            }
+            if (stdplus::raw::refFrom<nlmsghdr, Aligned>(msgs).nlmsg_flags &
+                NLM_F_DUMP_INTR)
+            {
+                dumpIntr = true;
+            }
+            detail::processMsg(msgs, done, cb);
+            num_msgs++;
+            if (done)
+            {
+                replies--;
+            }
+        }
+
+        if (replies == 0 && !msgs.empty())
+        {
+            throw std::runtime_error("Extra unprocessed netlink messages");
+        }
+    } while (replies > 0);
+    return num_msgs;
+}
+
+void performRequest(int protocol, void* data, size_t size, ReceiveCallback cb)
+{
+    PooledSocket sock(protocol);
+    sock.receive(sock.send(data, size), cb);
+    sock.reusable = true;
 }
 
 } // namespace detail
 
+InlineDump dumpInline(int sock, MsgBuilder& msg, ReceiveCallback cb,
+                      std::chrono::milliseconds timeout)
+{
+    sockaddr_nl local{};
+    socklen_t len = sizeof(local);
+    if (getsockname(sock, reinterpret_cast<sockaddr*>(&local), &len) < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "netlink getsockname");
+    }
+    auto req = msg.finish();
+    const auto seq = detail::stampSeq(req.data(), req.size());
+    detail::requestSend(sock, req.data(), req.size());
+
+    InlineDump ret;
+    std::vector<char> buf(8192);
+    bool done = false;
+    while (!done)
+    {
+        auto head = detail::peekDatagram(sock);
+        if (head < 0 && errno == ENOBUFS)
+        {
+            // Only events are lost, dump replies are never dropped
+            ret.overrun = true;
+            continue;
+        }
+        if (head < 0)
+        {
+            pollfd pfd{.fd = sock, .events = POLLIN, .revents = 0};
+            auto r = poll(&pfd, 1, timeout.count());
+            if (r < 0 && errno != EINTR)
+            {
+                throw std::system_error(errno, std::generic_category(),
+                                        "netlink poll");
+            }
+            if (r == 0)
+            {
+                throw std::runtime_error("Timed out waiting for netlink dump");
+            }
+            continue;
+        }
+        if (static_cast<size_t>(head) > buf.size())
+        {
+            buf.resize(head);
+        }
+        auto recvd = detail::recvDatagram(sock, buf);
+        if (recvd <= 0)
+        {
+            continue;
+        }
+
+        std::string_view msgs(buf.data(), recvd);
+        while (!msgs.empty())
+        {
+            const auto& hdr = stdplus::raw::refFrom<nlmsghdr, Aligned>(msgs);
+            if (hdr.nlmsg_len < sizeof(hdr) || msgs.size() < hdr.nlmsg_len)
+            {
+                throw std::runtime_error("Truncated nlmsg");
+            }
+            auto data = msgs.substr(NLMSG_HDRLEN, hdr.nlmsg_len - NLMSG_HDRLEN);
+            msgs.remove_prefix(
+                std::min<size_t>(NLMSG_ALIGN(hdr.nlmsg_len), msgs.size()));
+
+            if (hdr.nlmsg_pid != local.nl_pid || hdr.nlmsg_seq != seq)
+            {
+                if (hdr.nlmsg_type >= NLMSG_MIN_TYPE)
+                {
+                    ret.events++;
+                    cb(hdr, data);
+                }
+                continue;
+            }
+            if (hdr.nlmsg_type == NLMSG_DONE)
+            {
+                // Dumps report failures as a negative errno after the header
+                int err = 0;
+                if (data.size() >= sizeof(err))
+                {
+                    err = stdplus::raw::copyFrom<int>(data);
+                }
+                if (err < 0)
+                {
+                    throw std::system_error(-err, std::generic_category(),
+                                            "netlink dump");
+                }
+                done = true;
+                continue;
+            }
+            if (hdr.nlmsg_type == NLMSG_ERROR)
+            {
+                auto err = stdplus::raw::refFrom<nlmsgerr, Aligned>(data).error;
+                if (err != 0)
+                {
+                    throw std::system_error(-err, std::generic_category(),
+                                            "netlink dump");
+                }
+                continue;
+            }
+            if (hdr.nlmsg_type < NLMSG_MIN_TYPE)
+            {
+                continue;
+            }
+            if (hdr.nlmsg_flags & NLM_F_DUMP_INTR)
+            {
+                ret.interrupted = true;
+            }
+            ret.replies++;
+            cb(hdr, data);
+        }
+    }
+    return ret;
+}
+
+Request::Request(int protocol, MsgBuilder& msgs) :
+    sock(protocol), replies(msgs.count())
+{
+    auto buf = msgs.finish();
+    seq = sock.send(buf.data(), buf.size());
+}
+
+size_t Request::receive(ReceiveCallback cb)
+{
+    auto ret = sock.receive(seq, cb, replies);
+    sock.reusable = true;
+    return ret;
+}
+
+void MsgBuilder::beginMsg(uint16_t type, uint16_t flags)
+{
+    if (msgs > 0)
+    {
+        endMsg();
+    }
+    msgStart = buf.size();
+    nlmsghdr hdr{};
+    hdr.nlmsg_type = type;
+    hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+    append({reinterpret_cast<const char*>(&hdr), sizeof(hdr)});
+    msgs++;
+}
+
+void MsgBuilder::endMsg()
+{
+    if (!nests.empty())
+    {
+        throw std::runtime_error("Unterminated nested rtattr");
+    }
+    nlmsghdr hdr;
+    std::memcpy(&hdr, buf.data() + msgStart, sizeof(hdr));
+    hdr.nlmsg_len = buf.size() - msgStart;
+    std::memcpy(buf.data() + msgStart, &hdr, sizeof(hdr));
+}
+
+void MsgBuilder::append(std::string_view data)
+{
+    // Everything in a message is padded to the same 4 byte alignment
+    static_assert(NLMSG_ALIGNTO == RTA_ALIGNTO);
+    auto off = buf.size();
+    buf.resize(off + NLMSG_ALIGN(data.size()));
+    std::copy(data.begin(), data.end(), buf.begin() + off);
+    std::fill(buf.begin() + off + data.size(), buf.end(), '\0');
+}
+
+MsgBuilder& MsgBuilder::attr(unsigned short type, std::string_view data)
+{
+    if (msgs == 0)
+    {
+        throw std::runtime_error("rtattr outside of a message");
+    }
+    static_assert(sizeof(rtattr) == RTA_LENGTH(0));
+    rtattr hdr{};
+    hdr.rta_len = RTA_LENGTH(data.size());
+    hdr.rta_type = type;
+    append({reinterpret_cast<const char*>(&hdr), sizeof(hdr)});
+    append(data);
+    return *this;
+}
+
+MsgBuilder& MsgBuilder::beginNested(unsigned short type)
+{
+    attr(type, std::string_view());
+    nests.push_back(buf.size() - RTA_LENGTH(0));
+    return *this;
+}
+
+MsgBuilder& MsgBuilder::endNested()
+{
+    if (nests.empty())
+    {
+        throw std::runtime_error("No nested rtattr to end");
+    }
+    rtattr hdr;
+    std::memcpy(&hdr, buf.data() + nests.back(), sizeof(hdr));
+    hdr.rta_len = buf.size() - nests.back();
+    std::memcpy(buf.data() + nests.back(), &hdr, sizeof(hdr));
+    nests.pop_back();
+    return *this;
+}
+
+std::span<char> MsgBuilder::finish()
+{
+    if (msgs > 0)
+    {
+        endMsg();
+    }
+    return buf;
+}
+
+void MsgBuilder::clear() noexcept
+{
+    buf.clear();
+    nests.clear();
+    msgStart = 0;
+    msgs = 0;
+}
+
 size_t receive(int sock, ReceiveCallback cb)
 {
     // We need to make sure we have enough room for an entire packet otherwise
     // it gets truncated. The netlink docs guarantee packets will not exceed 8K
     std::array<char, 8192> buf;
 
-    iovec iov{};
-    iov.iov_base = buf.data();
-    iov.iov_len = buf.size();
-
-    sockaddr_nl from{};
-    from.nl_family = AF_NETLINK;
-
-    msghdr hdr{};
-    hdr.msg_name = &from;
-    hdr.msg_namelen = sizeof(from);
-    hdr.msg_iov = &iov;
-    hdr.msg_iovlen = 1;
-
     // We only do multiple recvs if we have a MULTI type message
     bool done = true;
     size_t num_msgs = 0;
     do
     {
-        ssize_t recvd = recvmsg(sock, &hdr, 0);
-        if (recvd < 0 && errno != EAGAIN)
-        {
-            throw std::system_error(errno, std::generic_category(),
-                                    "netlink recvmsg");
-        }
+        ssize_t recvd = detail::recvDatagram(sock, buf);
         if (recvd <= 0)
         {
             if (!done)
@@ -180,6 +572,130 @@ size_t receive(int sock, ReceiveCallback cb)
     return num_msgs;
 }
 
+BatchReceiver::BatchReceiver(size_t batch) :
+    batch(batch), iovs(batch), addrs(batch), hdrs(batch)
+{
+    // The netlink docs guarantee packets will not exceed 8K
+    grow(8192);
+}
+
+void BatchReceiver::grow(size_t size)
+{
+    bufSize = std::bit_ceil(size);
+    bufs.resize(batch * bufSize);
+    for (size_t i = 0; i < batch; ++i)
+    {
+        iovs[i].iov_base = bufs.data() + i * bufSize;
+        iovs[i].iov_len = bufSize;
+        hdrs[i].msg_hdr.msg_iov = &iovs[i];
+        hdrs[i].msg_hdr.msg_iovlen = 1;
+        hdrs[i].msg_hdr.msg_name = &addrs[i];
+    }
+}
+
+bool BatchReceiver::checkOverrun(int err)
+{
+    if (err != ENOBUFS)
+    {
+        return false;
+    }
+    // The error is reported once, everything still queued remains readable
+    stats.overruns++;
+    overrun = true;
+    return true;
+}
+
+size_t BatchReceiver::receive(int sock, ReceiveCallback cb)
+{
+    // Make sure the head datagram fits before reading, this also finds an
+    // empty socket without touching the buffers.
+    ssize_t head;
+    do
+    {
+        head = detail::peekDatagram(sock);
+        stats.syscalls++;
+    } while (head < 0 && checkOverrun(errno));
+    if (head < 0)
+    {
+        return 0;
+    }
+    if (static_cast<size_t>(head) > bufSize)
+    {
+        grow(head);
+    }
+
+    bool done = true;
+    size_t num_msgs = 0;
+    while (true)
+    {
+        for (size_t i = 0; i < batch; ++i)
+        {
+            addrs[i] = {};
+            addrs[i].nl_family = AF_NETLINK;
+            hdrs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            hdrs[i].msg_hdr.msg_flags = 0;
+        }
+        int recvd = recvmmsg(sock, hdrs.data(), batch,
+                             MSG_DONTWAIT | MSG_TRUNC, nullptr);
+        stats.syscalls++;
+        if (recvd < 0)
+        {
+            if (checkOverrun(errno))
+            {
+                continue;
+            }
+            if (errno != EAGAIN)
+            {
+                throw std::system_error(errno, std::generic_category(),
+                                        "netlink recvmmsg");
+            }
+            break;
+        }
+        stats.datagrams += recvd;
+
+        // With MSG_TRUNC the real length of a truncated datagram is reported
+        size_t needed = 0;
+        for (int i = 0; i < recvd; ++i)
+        {
+            const auto& hdr = hdrs[i];
+            if (hdr.msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                // The events it held are lost just like on ENOBUFS
+                stats.truncated++;
+                overrun = true;
+                needed = std::max<size_t>(needed, hdr.msg_len);
+                lg2::error("Dropped truncated netlink datagram: {SIZE} > "
+                           "{BUFSIZE}",
+                           "SIZE", hdr.msg_len, "BUFSIZE", bufSize);
+                continue;
+            }
+            std::string_view msgs(bufs.data() + i * bufSize, hdr.msg_len);
+            while (!msgs.empty())
+            {
+                detail::processMsg(msgs, done, cb);
+                num_msgs++;
+                stats.messages++;
+            }
+        }
+        if (needed > bufSize)
+        {
+            grow(needed);
+        }
+
+        // A short batch means the socket has been drained, new datagrams
+        // raise a fresh edge on the event loop.
+        if (static_cast<size_t>(recvd) < batch)
+        {
+            break;
+        }
+    }
+    if (!done)
+    {
+        throw std::runtime_error("netlink recvmmsg: Got partial multi msg");
+    }
+    return num_msgs;
+}
+
 std::tuple<rtattr, std::string_view> extractRtAttr(std::string_view& data)
 {
     const auto& hdr = stdplus::raw::refFrom<rtattr, Aligned>(data);
@@ -1,13 +1,23 @@
 #pragma once
+#include <linux/neighbour.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <sys/socket.h>
 
+#include <stdplus/fd/managed.hpp>
 #include <stdplus/function_view.hpp>
 #include <stdplus/raw.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace phosphor
 {
@@ -26,6 +36,50 @@ namespace detail
 
 void processMsg(std::string_view& msgs, bool& done, ReceiveCallback cb);
 
+/** @brief A request socket borrowed from a long-lived per-protocol pool
+ *
+ *  @details Sockets are only returned to the pool once marked reusable, so a
+ *           request that is abandoned part way through never hands its
+ *           leftover replies to the next user of the socket.
+ */
+class PooledSocket
+{
+  public:
+    explicit PooledSocket(int protocol);
+    PooledSocket(const PooledSocket&) = delete;
+    PooledSocket& operator=(const PooledSocket&) = delete;
+    ~PooledSocket();
+
+    /** @brief Stamps every message of the request with a fresh sequence
+     *         number and sends it
+     *
+     *  @param[in] data - The request buffer, holding one or more nlmsgs
+     *  @param[in] size - The size of the request buffer
+     *  @return The sequence number assigned to the request
+     */
+    uint32_t send(void* data, size_t size);
+
+    /** @brief Receives the complete reply to a previously sent request,
+     *         discarding stale replies to any other sequence number
+     *
+     *  @param[in] seq     - The sequence number returned by send()
+     *  @param[in] cb      - Called for each response message payload
+     *  @param[in] replies - The number of complete replies to wait for
+     *  @return The number of reply messages processed
+     */
+    size_t receive(uint32_t seq, ReceiveCallback cb, size_t replies = 1);
+
+    /** @brief Set once the socket has no outstanding replies */
+    bool reusable = false;
+
+    /** @brief Set if the kernel flagged the dump as inconsistent */
+    bool dumpIntr = false;
+
+  private:
+    int protocol;
+    stdplus::ManagedFd sock;
+};
+
 void performRequest(int protocol, void* data, size_t size, ReceiveCallback cb);
 
 } // namespace detail
@@ -37,6 +91,87 @@ void performRequest(int protocol, void* data, size_t size, ReceiveCallback cb);
  */
 size_t receive(int sock, ReceiveCallback cb);
 
+/** @class BatchReceiver
+ *  @brief Drains a non-blocking netlink socket with recvmmsg(), reading
+ *         up to a batch of datagrams per syscall into reusable buffers
+ *
+ *  @details Buffers start at the 8K netlink guarantees and grow whenever a
+ *           MSG_PEEK|MSG_TRUNC probe or a truncated read shows a larger
+ *           datagram. They never shrink, so steady state does no allocation.
+ */
+class BatchReceiver
+{
+  public:
+    /** @brief Counters describing how well reads are being batched */
+    struct Stats
+    {
+        size_t syscalls = 0;
+        size_t datagrams = 0;
+        size_t messages = 0;
+        size_t truncated = 0;
+        size_t overruns = 0;
+
+        /** @brief The mean number of nlmsgs read per syscall */
+        inline double msgsPerSyscall() const noexcept
+        {
+            return syscalls == 0 ? 0
+                                 : static_cast<double>(messages) / syscalls;
+        }
+    };
+
+    /** @brief Constructor
+     *
+     *  @param[in] batch - The maximum number of datagrams read per syscall
+     */
+    explicit BatchReceiver(size_t batch = 16);
+
+    BatchReceiver(const BatchReceiver&) = delete;
+    BatchReceiver& operator=(const BatchReceiver&) = delete;
+
+    /** @brief Receives every message currently queued on the socket
+     *
+     *  @param[in] sock - The non-blocking socket to drain
+     *  @param[in] cb   - Called for each message payload
+     *  @return The number of messages processed
+     */
+    size_t receive(int sock, ReceiveCallback cb);
+
+    /** @brief Gets the accumulated batching counters */
+    inline const Stats& getStats() const noexcept
+    {
+        return stats;
+    }
+
+    /** @brief Reports whether messages were lost, dropped by the kernel
+     *         (ENOBUFS) or in a truncated datagram, since the last call, in
+     *         which case the reader's view of the kernel state can no
+     *         longer be trusted
+     */
+    inline bool takeOverrun() noexcept
+    {
+        return std::exchange(overrun, false);
+    }
+
+    /** @brief Gets the current size of each buffer in the ring */
+    inline size_t getBufSize() const noexcept
+    {
+        return bufSize;
+    }
+
+  private:
+    size_t batch;
+    size_t bufSize = 0;
+    std::vector<char> bufs;
+    std::vector<iovec> iovs;
+    std::vector<sockaddr_nl> addrs;
+    std::vector<mmsghdr> hdrs;
+    Stats stats;
+    bool overrun = false;
+
+    void grow(size_t size);
+    bool checkOverrun(int err);
+};
+
 /* @brief Call on an rtnetlink payload
  *        Updates the input to remove the attr parsed out.
  *
@@ -59,6 +194,284 @@ constexpr const T& extractRtData(std::string_view& data)
  */
 std::tuple<rtattr, std::string_view> extractRtAttr(std::string_view& data);
 
+/** @class RtAttrs
+ *  @brief Indexes a block of rtattrs by type in a single pass
+ *
+ *  @details Attributes are stored as offsets into the original buffer, so
+ *           nothing is copied or allocated until a field is decoded, and the
+ *           table stays small enough to clear cheaply for every message.
+ *           Types above Max are skipped and later duplicates replace
+ *           earlier ones.
+ */
+template <unsigned short Max>
+class RtAttrs
+{
+  public:
+    /** @brief Indexes the attributes
+     *
+     *  @param[in] data - The buffer holding the rtattrs
+     */
+    explicit RtAttrs(std::string_view data) : base(data.data())
+    {
+        while (!data.empty())
+        {
+            auto [hdr, attr] = extractRtAttr(data);
+            auto type = hdr.rta_type & NLA_TYPE_MASK;
+            if (type <= Max)
+            {
+                // A payload always follows its header, so 0 marks absence
+                offs[type] = attr.data() - base;
+                lens[type] = attr.size();
+            }
+        }
+    }
+
+    /** @brief Gets the payload of an attribute, with a null data() if the
+     *         attribute was not present
+     */
+    constexpr std::string_view operator[](unsigned short type) const noexcept
+    {
+        if (!contains(type))
+        {
+            return {};
+        }
+        return {base + offs[type], lens[type]};
+    }
+
+    /** @brief Whether the attribute was present */
+    constexpr bool contains(unsigned short type) const noexcept
+    {
+        return offs[type] != 0;
+    }
+
+    /** @brief Decodes a trivial attribute if present */
+    template <typename T>
+    constexpr std::optional<T> get(unsigned short type) const
+    {
+        if (!contains(type))
+        {
+            return std::nullopt;
+        }
+        return stdplus::raw::copyFrom<T>((*this)[type]);
+    }
+
+  private:
+    const char* base;
+    std::array<uint32_t, Max + 1> offs = {};
+    std::array<uint16_t, Max + 1> lens = {};
+};
+
+/** @brief The highest attribute type carried by each rtnetlink message */
+template <typename T>
+struct RtmAttrMax;
+template <>
+struct RtmAttrMax<ifinfomsg> : std::integral_constant<unsigned short, IFLA_MAX>
+{};
+template <>
+struct RtmAttrMax<ifaddrmsg> : std::integral_constant<unsigned short, IFA_MAX>
+{};
+template <>
+struct RtmAttrMax<rtmsg> : std::integral_constant<unsigned short, RTA_MAX>
+{};
+template <>
+struct RtmAttrMax<ndmsg> : std::integral_constant<unsigned short, NDA_MAX>
+{};
+
+/** @brief The attribute index for a given rtnetlink message type */
+template <typename T>
+using RtmAttrs = RtAttrs<RtmAttrMax<T>::value>;
+
+/** @brief An rtnetlink message split into its header and attributes */
+template <typename T>
+struct Rtm
+{
+    const T& msg;
+    RtmAttrs<T> attrs;
+};
+
+/* @brief Call on an rtnetlink payload to split out the message header and
+ *        index its attributes
+ *
+ * @param[in] data - The buffer holding rtpayload to parse
+ * @return The rt msg and its attributes, built in place for the caller
+ */
+template <typename T>
+Rtm<T> parseRtm(std::string_view data)
+{
+    const T& msg = extractRtData<T>(data);
+    return {msg, RtmAttrs<T>(data)};
+}
+
+/** @class MsgBuilder
+ *  @brief Builds one or more netlink messages with attributes into a single
+ *         buffer, so a batch of changes can be sent in one datagram
+ *
+ *  @details The buffer is kept across clear() so a long lived builder stops
+ *           allocating once it has seen its largest batch. Every message is
+ *           flagged NLM_F_REQUEST | NLM_F_ACK; sequence numbers are stamped
+ *           when the batch is sent.
+ */
+class MsgBuilder
+{
+  public:
+    /** @brief Starts a new message, completing the previous one
+     *
+     *  @param[in] type  - The netlink message type
+     *  @param[in] flags - Additional netlink flags for the message
+     *  @param[in] msg   - The fixed payload leading the message
+     */
+    template <typename T>
+    MsgBuilder& begin(uint16_t type, uint16_t flags, const T& msg)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        beginMsg(type, flags);
+        append({reinterpret_cast<const char*>(&msg), sizeof(msg)});
+        return *this;
+    }
+
+    /** @brief Appends an attribute holding the raw bytes of data
+     *
+     *  @param[in] type - The attribute type
+     *  @param[in] data - The attribute payload
+     */
+    MsgBuilder& attr(unsigned short type, std::string_view data);
+
+    /** @brief Appends an attribute holding a trivially copyable value */
+    template <typename T>
+        requires(std::is_trivially_copyable_v<T> &&
+                 !std::is_convertible_v<const T&, std::string_view>)
+    MsgBuilder& attr(unsigned short type, const T& data)
+    {
+        return attr(type, std::string_view(
+                              reinterpret_cast<const char*>(&data),
+                              sizeof(data)));
+    }
+
+    /** @brief Opens a nested attribute, every attribute added until the
+     *         matching endNested() becomes part of its payload
+     */
+    MsgBuilder& beginNested(unsigned short type);
+    MsgBuilder& endNested();
+
+    /** @brief Completes the last message
+     *
+     *  @return The buffer holding every message built so far
+     */
+    std::span<char> finish();
+
+    /** @brief The number of messages started so far */
+    inline size_t count() const noexcept
+    {
+        return msgs;
+    }
+
+    /** @brief Drops all messages but keeps the buffer for reuse */
+    void clear() noexcept;
+
+  private:
+    std::vector<char> buf;
+    std::vector<size_t> nests;
+    size_t msgStart = 0;
+    size_t msgs = 0;
+
+    void beginMsg(uint16_t type, uint16_t flags);
+    void endMsg();
+    void append(std::string_view data);
+};
+
+/** @brief A netlink request that has been sent but whose reply has not yet
+ *         been read. Constructing several requests before receiving any of
+ *         them lets the kernel work on all of them at once.
+ */
+class Request
+{
+  public:
+    /** @brief Sends the request on a socket borrowed from the pool
+     *
+     *  @param[in] protocol - The netlink protocol to use when opening the socket
+     *  @param[in] type     - The netlink message type
+     *  @param[in] flags    - Additional netlink flags for the request
+     *  @param[in] msg      - The message payload for the request
+     */
+    template <typename T>
+    Request(int protocol, uint16_t type, uint16_t flags, const T& msg) :
+        sock(protocol)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        struct
+        {
+            nlmsghdr hdr;
+            T msg;
+        } data{};
+        data.hdr.nlmsg_len = sizeof(data);
+        data.hdr.nlmsg_type = type;
+        data.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+        data.msg = msg;
+
+        seq = sock.send(&data, sizeof(data));
+    }
+
+    /** @brief Sends every message of a batch in one datagram, the reply is
+     *         complete once each message has been answered
+     *
+     *  @param[in] protocol - The netlink protocol to use when opening the socket
+     *  @param[in] msgs     - The batch of messages, at most one of them a dump
+     */
+    Request(int protocol, MsgBuilder& msgs);
+
+    /** @brief Blocks until the whole reply has been received
+     *
+     *  @param[in] cb - Called for each response message payload
+     *  @return The number of reply messages processed
+     */
+    size_t receive(ReceiveCallback cb);
+
+    /** @brief Whether the kernel flagged the received dump with
+     *         NLM_F_DUMP_INTR, meaning the state changed while it was taken
+     *         and the dump may be inconsistent
+     */
+    inline bool interrupted() const noexcept
+    {
+        return sock.dumpIntr;
+    }
+
+  private:
+    detail::PooledSocket sock;
+    uint32_t seq;
+    size_t replies = 1;
+};
+
+/** @brief The outcome of a dump taken by dumpInline() */
+struct InlineDump
+{
+    /** @brief Replies to the dump itself */
+    size_t replies = 0;
+    /** @brief Events read while waiting for the replies */
+    size_t events = 0;
+    /** @brief Whether the kernel flagged the dump with NLM_F_DUMP_INTR */
+    bool interrupted = false;
+    /** @brief Whether the socket overran, so events may have been lost */
+    bool overrun = false;
+};
+
+/** @brief Takes a dump on a socket which is also subscribed to events
+ *
+ *  @details Replies are told apart from events by the port and sequence
+ *           number of the request, and both are handed to the callback in
+ *           the order the kernel queued them. Anything read after a reply
+ *           therefore happened after the state it describes. Events still
+ *           queued once the dump is complete are left on the socket.
+ *
+ *  @param[in] sock    - The non-blocking subscribed socket
+ *  @param[in] msg     - The dump request
+ *  @param[in] cb      - Called for each reply and event payload
+ *  @param[in] timeout - How long to wait for the next part of the reply
+ */
+InlineDump dumpInline(
+    int sock, MsgBuilder& msg, ReceiveCallback cb,
+    std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
 /** @brief Performs a netlink request of the specified type with the given
  *  message Calls the callback upon receiving
  *
@@ -72,19 +485,7 @@ template <typename T>
 void performRequest(int protocol, uint16_t type, uint16_t flags, const T& msg,
                     ReceiveCallback cb)
 {
-    static_assert(std::is_trivially_copyable_v<T>);
-
-    struct
-    {
-        nlmsghdr hdr;
-        T msg;
-    } data{};
-    data.hdr.nlmsg_len = sizeof(data);
-    data.hdr.nlmsg_type = type;
-    data.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
-    data.msg = msg;
-
-    detail::performRequest(protocol, &data, sizeof(data), cb);
+    Request(protocol, type, flags, msg).receive(cb);
 }
 
 } // namespace netlink
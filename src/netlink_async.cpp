@@ -0,0 +1,236 @@
+#include "netlink_async.hpp"
+
+#include <linux/netlink.h>
+#include <sys/socket.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <stdplus/fd/create.hpp>
+#include <stdplus/fd/ops.hpp>
+#include <stdplus/raw.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+namespace phosphor::network::netlink
+{
+
+using stdplus::raw::Aligned;
+
+static stdplus::ManagedFd makeSocket(int protocol)
+{
+    using namespace stdplus::fd;
+
+    auto sock = socket(SocketDomain::Netlink, SocketType::Raw,
+                       static_cast<stdplus::fd::SocketProto>(protocol));
+
+    sock.fcntlSetfl(sock.fcntlGetfl().set(FileFlag::NonBlock));
+
+    sockaddr_nl local{};
+    local.nl_family = AF_NETLINK;
+    bind(sock, local);
+
+    return sock;
+}
+
+AsyncRequester::AsyncRequester(const sdeventplus::Event& event, int protocol) :
+    sock(makeSocket(protocol)),
+    io(event, sock.get(), EPOLLIN, [this](auto&&...) { readable(); }),
+    timer(event, [this](auto&) { expire(); })
+{
+    timer.setEnabled(false);
+}
+
+void AsyncRequester::send(void* data, size_t size,
+                          std::chrono::microseconds timeout,
+                          AsyncMsgCallback&& msgCb, AsyncDoneCallback&& doneCb)
+{
+    auto& hdr = *reinterpret_cast<nlmsghdr*>(data);
+    hdr.nlmsg_seq = nextSeq++;
+
+    sockaddr_nl dst{};
+    dst.nl_family = AF_NETLINK;
+
+    iovec iov{};
+    iov.iov_base = data;
+    iov.iov_len = size;
+
+    msghdr mhdr{};
+    mhdr.msg_name = reinterpret_cast<sockaddr*>(&dst);
+    mhdr.msg_namelen = sizeof(dst);
+    mhdr.msg_iov = &iov;
+    mhdr.msg_iovlen = 1;
+
+    if (sendmsg(sock.get(), &mhdr, 0) < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "netlink sendmsg");
+    }
+
+    requests.insert_or_assign(
+        hdr.nlmsg_seq,
+        Pending{.msgCb = std::move(msgCb),
+                .doneCb = std::move(doneCb),
+                .deadline = std::chrono::steady_clock::now() + timeout});
+    rearm();
+}
+
+void AsyncRequester::readable()
+{
+    std::array<char, 8192> buf;
+
+    iovec iov{};
+    iov.iov_base = buf.data();
+    iov.iov_len = buf.size();
+
+    sockaddr_nl from{};
+    from.nl_family = AF_NETLINK;
+
+    msghdr hdr{};
+    hdr.msg_name = &from;
+    hdr.msg_namelen = sizeof(from);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+
+    while (true)
+    {
+        ssize_t recvd = recvmsg(sock.get(), &hdr, MSG_DONTWAIT);
+        if (recvd < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                lg2::error("Failed receiving netlink replies: {ERROR}",
+                           "ERROR", std::system_category().message(errno));
+            }
+            break;
+        }
+        if (recvd == 0)
+        {
+            break;
+        }
+        std::string_view msgs(buf.data(), recvd);
+        try
+        {
+            while (!msgs.empty())
+            {
+                dispatch(msgs);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Dropping malformed netlink reply: {ERROR}", "ERROR",
+                       e);
+        }
+    }
+    rearm();
+}
+
+void AsyncRequester::dispatch(std::string_view& msgs)
+{
+    const auto& hdr = stdplus::raw::refFrom<nlmsghdr, Aligned>(msgs);
+    if (hdr.nlmsg_len < sizeof(hdr) || msgs.size() < hdr.nlmsg_len)
+    {
+        throw std::runtime_error("Truncated nlmsg");
+    }
+    auto msg = msgs.substr(NLMSG_HDRLEN, hdr.nlmsg_len - NLMSG_HDRLEN);
+    msgs.remove_prefix(
+        std::min<size_t>(NLMSG_ALIGN(hdr.nlmsg_len), msgs.size()));
+
+    auto it = requests.find(hdr.nlmsg_seq);
+    if (it == requests.end())
+    {
+        // Replies to requests that already timed out
+        return;
+    }
+    switch (hdr.nlmsg_type)
+    {
+        case NLMSG_NOOP:
+            return;
+        case NLMSG_DONE:
+        {
+            // Dumps report failures as a negative errno after the header
+            int err = 0;
+            if (msg.size() >= sizeof(err))
+            {
+                err = stdplus::raw::copyFrom<int>(msg);
+            }
+            complete(hdr.nlmsg_seq, err < 0 ? -err : 0);
+            return;
+        }
+        case NLMSG_ERROR:
+        {
+            auto err = stdplus::raw::refFrom<nlmsgerr, Aligned>(msg).error;
+            complete(hdr.nlmsg_seq, err < 0 ? -err : err);
+            return;
+        }
+    }
+    if (it->second.msgCb)
+    {
+        try
+        {
+            it->second.msgCb(hdr, msg);
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Failed handling netlink reply: {ERROR}", "ERROR", e);
+            complete(hdr.nlmsg_seq, EBADMSG);
+        }
+    }
+}
+
+void AsyncRequester::complete(uint32_t seq, int err)
+{
+    auto it = requests.find(seq);
+    if (it == requests.end())
+    {
+        return;
+    }
+    auto doneCb = std::move(it->second.doneCb);
+    requests.erase(it);
+    if (doneCb)
+    {
+        doneCb(err);
+    }
+}
+
+void AsyncRequester::expire()
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<uint32_t> expired;
+    for (const auto& [seq, req] : requests)
+    {
+        if (req.deadline <= now)
+        {
+            expired.push_back(seq);
+        }
+    }
+    for (auto seq : expired)
+    {
+        complete(seq, ETIMEDOUT);
+    }
+    rearm();
+}
+
+void AsyncRequester::rearm()
+{
+    if (requests.empty())
+    {
+        timer.setEnabled(false);
+        return;
+    }
+    auto next = std::min_element(requests.begin(), requests.end(),
+                                 [](const auto& a, const auto& b) {
+                                     return a.second.deadline <
+                                            b.second.deadline;
+                                 })
+                    ->second.deadline;
+    auto now = std::chrono::steady_clock::now();
+    timer.restartOnce(
+        next > now ? std::chrono::ceil<std::chrono::microseconds>(next - now)
+                   : std::chrono::microseconds::zero());
+}
+
+} // namespace phosphor::network::netlink
@@ -0,0 +1,114 @@
+#pragma once
+#include <linux/netlink.h>
+
+#include <function2/function2.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+#include <sdeventplus/utility/timer.hpp>
+#include <stdplus/fd/managed.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace phosphor::network::netlink
+{
+
+/** @brief Called on each reply message of an asynchronous request */
+using AsyncMsgCallback =
+    fu2::unique_function<void(const nlmsghdr&, std::string_view)>;
+
+/** @brief Called exactly once when an asynchronous request finishes
+ *
+ *  @param[in] err - 0 on success, otherwise the errno of the failure
+ *                   (ETIMEDOUT if the deadline passed first)
+ */
+using AsyncDoneCallback = fu2::unique_function<void(int err)>;
+
+/** @class AsyncRequester
+ *  @brief Issues netlink requests without blocking the event loop
+ *
+ *  @details Replies are read from a non-blocking socket whenever the event
+ *           loop reports it readable and are routed to their request by
+ *           sequence number. Every request carries a deadline, after which
+ *           it completes with ETIMEDOUT and any late replies are dropped.
+ */
+class AsyncRequester
+{
+  public:
+    /** @brief Opens the request socket and attaches it to the event loop
+     *
+     *  @param[in] event    - The event loop driving replies and deadlines
+     *  @param[in] protocol - The netlink protocol to open the socket with
+     */
+    AsyncRequester(const sdeventplus::Event& event, int protocol);
+
+    AsyncRequester(AsyncRequester&&) = delete;
+    AsyncRequester& operator=(AsyncRequester&&) = delete;
+
+    /** @brief Sends a request with a trivially copyable payload
+     *
+     *  @param[in] type    - The netlink message type
+     *  @param[in] flags   - Additional netlink flags for the request
+     *  @param[in] msg     - The message payload for the request
+     *  @param[in] timeout - How long to wait for the complete reply
+     *  @param[in] msgCb   - Called for each reply payload, may be empty
+     *  @param[in] doneCb  - Called once the request has finished
+     */
+    template <typename T>
+    void request(uint16_t type, uint16_t flags, const T& msg,
+                 std::chrono::microseconds timeout, AsyncMsgCallback&& msgCb,
+                 AsyncDoneCallback&& doneCb)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        struct
+        {
+            nlmsghdr hdr;
+            T msg;
+        } data{};
+        data.hdr.nlmsg_len = sizeof(data);
+        data.hdr.nlmsg_type = type;
+        data.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+        data.msg = msg;
+
+        send(&data, sizeof(data), timeout, std::move(msgCb),
+             std::move(doneCb));
+    }
+
+    /** @brief Sends a pre-built request buffer starting with an nlmsghdr.
+     *         The sequence number is filled in by the requester.
+     */
+    void send(void* data, size_t size, std::chrono::microseconds timeout,
+              AsyncMsgCallback&& msgCb, AsyncDoneCallback&& doneCb);
+
+    /** @brief The number of requests still waiting on a reply */
+    inline size_t pending() const noexcept
+    {
+        return requests.size();
+    }
+
+  private:
+    struct Pending
+    {
+        AsyncMsgCallback msgCb;
+        AsyncDoneCallback doneCb;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    stdplus::ManagedFd sock;
+    sdeventplus::source::IO io;
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+    std::unordered_map<uint32_t, Pending> requests;
+    uint32_t nextSeq = 1;
+
+    void readable();
+    void dispatch(std::string_view& msgs);
+    void complete(uint32_t seq, int err);
+    void expire();
+    void rearm();
+};
+
+} // namespace phosphor::network::netlink
@@ -0,0 +1,67 @@
+#include "netlink_debug.hpp"
+
+#include <chrono>
+#include <utility>
+
+namespace phosphor
+{
+namespace network
+{
+
+NetlinkDebug::NetlinkDebug(sdbusplus::bus_t& bus,
+                           stdplus::zstring_view objPath,
+                           netlink::MessageStats& stats,
+                           ReaderStats&& readerStats) :
+    NetlinkDebugObj(bus, objPath.c_str(),
+                    NetlinkDebugObj::action::emit_interface_added),
+    stats(stats), readerStats(std::move(readerStats))
+{}
+
+std::map<std::string, std::tuple<uint64_t, uint64_t, uint64_t, uint64_t,
+                                 uint64_t, std::vector<uint64_t>>>
+    NetlinkDebug::getMessageStats()
+{
+    using netlink::MessageStats;
+    decltype(getMessageStats()) ret;
+    for (auto type = MessageStats::minType; type <= MessageStats::maxType;
+         ++type)
+    {
+        const auto& c = *stats.get(type);
+        if (c.messages == 0 && c.errors == 0 && c.applied == 0)
+        {
+            continue;
+        }
+        ret.emplace(MessageStats::typeName(type),
+                    std::make_tuple(
+                        c.messages.load(), c.bytes.load(), c.errors.load(),
+                        c.applied, c.appliedNs,
+                        std::vector<uint64_t>(c.latency.begin(),
+                                              c.latency.end())));
+    }
+    return ret;
+}
+
+std::map<std::string, uint64_t> NetlinkDebug::getReaderStats()
+{
+    auto r = readerStats();
+    auto ns = [](std::chrono::nanoseconds d) -> uint64_t {
+        return d.count();
+    };
+    return {
+        {"Capacity", r.capacity},
+        {"Depth", r.depth},
+        {"MaxDepth", r.maxDepth},
+        {"Dropped", r.dropped},
+        {"Wakes", r.wakes},
+        {"WakeLatencyLastNs", ns(r.lastWakeLatency)},
+        {"WakeLatencyMaxNs", ns(r.maxWakeLatency)},
+    };
+}
+
+void NetlinkDebug::reset()
+{
+    stats.reset();
+}
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,62 @@
+#pragma once
+#include "netlink_reader.hpp"
+#include "netlink_stats.hpp"
+#include "xyz/openbmc_project/Network/Debug/Netlink/server.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <function2/function2.hpp>
+#include <sdbusplus/server/object.hpp>
+#include <stdplus/zstring_view.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor
+{
+namespace network
+{
+
+using NetlinkDebugIntf =
+    sdbusplus::xyz::openbmc_project::Network::Debug::server::Netlink;
+
+using NetlinkDebugObj = sdbusplus::server::object_t<NetlinkDebugIntf>;
+
+/** @class NetlinkDebug
+ *  @brief Exposes the rtnetlink handler and event reader counters on D-Bus.
+ *  @details Counters are only collected into a reply when asked for, so
+ *           nothing is emitted while messages are being handled.
+ */
+class NetlinkDebug : public NetlinkDebugObj
+{
+  public:
+    /** @brief Fetches the current event reader counters */
+    using ReaderStats = fu2::unique_function<netlink::EventReader::Stats()>;
+
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] objPath - Path to attach at.
+     *  @param[in] stats - The counters to expose.
+     *  @param[in] readerStats - Fetches the event reader counters.
+     */
+    NetlinkDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+                 netlink::MessageStats& stats, ReaderStats&& readerStats);
+
+    std::map<std::string,
+             std::tuple<uint64_t, uint64_t, uint64_t, uint64_t, uint64_t,
+                        std::vector<uint64_t>>>
+        getMessageStats() override;
+
+    std::map<std::string, uint64_t> getReaderStats() override;
+
+    void reset() override;
+
+  private:
+    netlink::MessageStats& stats;
+    ReaderStats readerStats;
+};
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,181 @@
+#include "netlink_reader.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <optional>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+namespace phosphor::network::netlink
+{
+
+static stdplus::ManagedFd makeEventFd()
+{
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+    return stdplus::ManagedFd(std::move(fd));
+}
+
+static void post(int fd)
+{
+    uint64_t one = 1;
+    // Only fails once the counter is saturated, which still wakes the poller
+    std::ignore = write(fd, &one, sizeof(one));
+}
+
+static int64_t now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+EventReader::EventReader(int fd, size_t capacity, MessageStats* msgStats,
+                         bool rawRoutes) :
+    fd(fd), msgStats(msgStats), rawRoutes(rawRoutes), wake(makeEventFd()),
+    stop(makeEventFd()), ring(capacity)
+{
+    stats.capacity = ring.capacity();
+    thread = std::thread([this] { run(); });
+}
+
+EventReader::~EventReader()
+{
+    post(stop.get());
+    thread.join();
+}
+
+void EventReader::run()
+{
+    auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
+        if (msgStats != nullptr)
+        {
+            msgStats->received(hdr.nlmsg_type, hdr.nlmsg_len);
+        }
+        std::optional<Item> item;
+        if (!rawRoutes ||
+            (hdr.nlmsg_type != RTM_NEWROUTE && hdr.nlmsg_type != RTM_DELROUTE))
+        {
+            try
+            {
+                auto e = eventFromRtm(hdr.nlmsg_type, data);
+                if (!e)
+                {
+                    return;
+                }
+                item.emplace(*std::move(e));
+            }
+            catch (const std::exception&)
+            {}
+        }
+        if (!item)
+        {
+            item.emplace(Undecoded{hdr, std::string(data)});
+        }
+        if (!ring.push(*std::move(item)))
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            resyncPending = true;
+        }
+    };
+
+    std::array<pollfd, 2> fds{};
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = stop.get();
+    fds[1].events = POLLIN;
+    while (true)
+    {
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            lg2::error("Netlink reader failed to poll: {ERROR}", "ERROR",
+                       std::generic_category().message(errno));
+            return;
+        }
+        if (fds[1].revents != 0)
+        {
+            return;
+        }
+        try
+        {
+            rx.receive(fd, cb);
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Netlink reader failed to receive: {ERROR}", "ERROR",
+                       e);
+            resyncPending = true;
+        }
+        if (rx.takeOverrun())
+        {
+            resyncPending = true;
+        }
+        notify();
+    }
+}
+
+void EventReader::notify()
+{
+    if (ring.size() == 0 && !resyncPending)
+    {
+        return;
+    }
+    // Pairs with the fence in drain(), either the consumer sees what was
+    // just queued or we see that it has woken up and signal it again
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t expected = 0;
+    if (wakeStamp.compare_exchange_strong(expected, now()))
+    {
+        post(wake.get());
+    }
+}
+
+size_t EventReader::drain(stdplus::function_view<void(Item&&)> cb)
+{
+    uint64_t count;
+    std::ignore = read(wake.get(), &count, sizeof(count));
+    auto stamp = wakeStamp.exchange(0);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (stamp != 0)
+    {
+        std::chrono::nanoseconds latency(now() - stamp);
+        stats.wakes++;
+        stats.lastWakeLatency = latency;
+        stats.maxWakeLatency = std::max(stats.maxWakeLatency, latency);
+    }
+    stats.depth = ring.size();
+    stats.maxDepth = std::max(stats.maxDepth, stats.depth);
+
+    size_t ret = 0;
+    while (auto item = ring.pop())
+    {
+        cb(*std::move(item));
+        ret++;
+    }
+    return ret;
+}
+
+EventReader::Stats EventReader::getStats() const noexcept
+{
+    auto ret = stats;
+    ret.dropped = dropped.load(std::memory_order_relaxed);
+    return ret;
+}
+
+} // namespace phosphor::network::netlink
@@ -0,0 +1,119 @@
+#pragma once
+#include "netlink.hpp"
+#include "netlink_stats.hpp"
+#include "rtnetlink.hpp"
+#include "spsc_ring.hpp"
+
+#include <stdplus/fd/managed.hpp>
+#include <stdplus/function_view.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <variant>
+
+namespace phosphor::network::netlink
+{
+
+/** @class EventReader
+ *  @brief Reads and decodes rtnetlink events on a dedicated thread
+ *
+ *  @details Decoded events are handed to the owning thread through a
+ *           bounded lock-free ring, and an eventfd becomes readable when
+ *           the ring goes from drained to non-empty, so the consumer stays
+ *           on its event loop and keeps sole ownership of the manager.
+ *           When the ring fills up or the socket overruns, events are lost
+ *           and the consumer is asked to resync instead.
+ */
+class EventReader
+{
+  public:
+    /** @brief A message passed on undecoded, either because it failed to
+     *         decode and the consumer decides whether that is worth
+     *         reporting, or because the consumer asked for the raw message
+     */
+    struct Undecoded
+    {
+        nlmsghdr hdr;
+        std::string data;
+    };
+
+    using Item = std::variant<Event, Undecoded>;
+
+    /** @brief Counters describing the queue between the two threads */
+    struct Stats
+    {
+        size_t capacity = 0;
+        /** @brief Items queued when the consumer last woke up */
+        size_t depth = 0;
+        size_t maxDepth = 0;
+        size_t dropped = 0;
+        size_t wakes = 0;
+        /** @brief Time from the first queued item to the consumer waking */
+        std::chrono::nanoseconds lastWakeLatency{};
+        std::chrono::nanoseconds maxWakeLatency{};
+    };
+
+    /** @brief Constructor, starts the reader thread
+     *
+     *  @param[in] fd        - The non-blocking event socket to read
+     *  @param[in] capacity  - The minimum number of queued items
+     *  @param[in] msgStats  - Counts the messages read if non-null
+     *  @param[in] rawRoutes - Pass every route message on undecoded, for
+     *                         consumers which need more than gateways
+     */
+    EventReader(int fd, size_t capacity, MessageStats* msgStats = nullptr,
+                bool rawRoutes = false);
+    ~EventReader();
+
+    EventReader(const EventReader&) = delete;
+    EventReader& operator=(const EventReader&) = delete;
+
+    /** @brief The fd to poll for readability in the consumer */
+    inline int getWakeFd() const noexcept
+    {
+        return wake.get();
+    }
+
+    /** @brief Hands every queued item to the callback, consumer only
+     *
+     *  @param[in] cb - Called for each item in the order it was read
+     *  @return The number of items drained
+     */
+    size_t drain(stdplus::function_view<void(Item&&)> cb);
+
+    /** @brief Checks and clears whether events were lost since the last
+     *         call, consumer only
+     */
+    inline bool takeResync() noexcept
+    {
+        return resyncPending.exchange(false);
+    }
+
+    /** @brief Gets the queue counters, consumer only */
+    Stats getStats() const noexcept;
+
+  private:
+    int fd;
+    MessageStats* msgStats;
+    bool rawRoutes;
+    stdplus::ManagedFd wake;
+    stdplus::ManagedFd stop;
+    BatchReceiver rx;
+    SpscRing<Item> ring;
+    std::atomic<bool> resyncPending = false;
+    std::atomic<size_t> dropped = 0;
+    /** @brief Steady clock time of the first item since the consumer last
+     *         woke up, 0 while no wakeup is outstanding
+     */
+    std::atomic<int64_t> wakeStamp = 0;
+    Stats stats;
+    std::thread thread;
+
+    void run();
+    void notify();
+};
+
+} // namespace phosphor::network::netlink
@@ -0,0 +1,96 @@
+#include "netlink_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+
+namespace phosphor::network::netlink
+{
+
+MessageStats::Counters* MessageStats::find(uint16_t type) noexcept
+{
+    if (type < minType || type > maxType)
+    {
+        return nullptr;
+    }
+    return &counters[type - minType];
+}
+
+const MessageStats::Counters* MessageStats::get(uint16_t type) const noexcept
+{
+    return const_cast<MessageStats*>(this)->find(type);
+}
+
+void MessageStats::received(uint16_t type, size_t bytes) noexcept
+{
+    if (auto c = find(type); c != nullptr)
+    {
+        c->messages.fetch_add(1, std::memory_order_relaxed);
+        c->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+void MessageStats::failed(uint16_t type) noexcept
+{
+    if (auto c = find(type); c != nullptr)
+    {
+        c->errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MessageStats::applied(uint16_t type,
+                           std::chrono::nanoseconds dur) noexcept
+{
+    if (auto c = find(type); c != nullptr)
+    {
+        c->applied++;
+        c->appliedNs += dur.count();
+        c->latency[bucket(dur)]++;
+    }
+}
+
+void MessageStats::reset() noexcept
+{
+    for (auto& c : counters)
+    {
+        c.messages = 0;
+        c.bytes = 0;
+        c.errors = 0;
+        c.applied = 0;
+        c.appliedNs = 0;
+        c.latency = {};
+    }
+}
+
+size_t MessageStats::bucket(std::chrono::nanoseconds dur) noexcept
+{
+    auto units = static_cast<uint64_t>(std::max<int64_t>(dur.count(), 0)) >>
+                 10;
+    return std::min<size_t>(std::bit_width(units), buckets - 1);
+}
+
+std::string MessageStats::typeName(uint16_t type)
+{
+    switch (type)
+    {
+        case RTM_NEWLINK:
+            return "RTM_NEWLINK";
+        case RTM_DELLINK:
+            return "RTM_DELLINK";
+        case RTM_NEWADDR:
+            return "RTM_NEWADDR";
+        case RTM_DELADDR:
+            return "RTM_DELADDR";
+        case RTM_NEWROUTE:
+            return "RTM_NEWROUTE";
+        case RTM_DELROUTE:
+            return "RTM_DELROUTE";
+        case RTM_NEWNEIGH:
+            return "RTM_NEWNEIGH";
+        case RTM_DELNEIGH:
+            return "RTM_DELNEIGH";
+    }
+    return std::format("RTM_{}", type);
+}
+
+} // namespace phosphor::network::netlink
@@ -0,0 +1,73 @@
+#pragma once
+#include <linux/rtnetlink.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace phosphor::network::netlink
+{
+
+/** @class MessageStats
+ *  @brief Per message type counters for the rtnetlink event handlers
+ *
+ *  @details Counters for receiving messages are relaxed atomics as the
+ *           reader thread may bump them, applying messages only ever happens
+ *           on the event loop so those are plain counters.
+ */
+class MessageStats
+{
+  public:
+    /** @brief The number of latency histogram buckets, bucket i counts
+     *         samples under 1024 << i nanoseconds and the last one also
+     *         counts everything slower
+     */
+    static constexpr size_t buckets = 16;
+
+    struct Counters
+    {
+        std::atomic<uint64_t> messages = 0;
+        std::atomic<uint64_t> bytes = 0;
+        std::atomic<uint64_t> errors = 0;
+        uint64_t applied = 0;
+        uint64_t appliedNs = 0;
+        std::array<uint64_t, buckets> latency = {};
+    };
+
+    /** @brief Records a message read from the socket */
+    void received(uint16_t type, size_t bytes) noexcept;
+
+    /** @brief Records a message which failed to decode or apply */
+    void failed(uint16_t type) noexcept;
+
+    /** @brief Records the time taken to apply a message */
+    void applied(uint16_t type, std::chrono::nanoseconds dur) noexcept;
+
+    /** @brief Gets the counters of a message type
+     *
+     *  @return nullptr for types outside of rtnetlink
+     */
+    const Counters* get(uint16_t type) const noexcept;
+
+    /** @brief Clears every counter */
+    void reset() noexcept;
+
+    /** @brief The histogram bucket a sample is counted in */
+    static size_t bucket(std::chrono::nanoseconds dur) noexcept;
+
+    /** @brief A printable name for a message type, e.g. RTM_NEWLINK */
+    static std::string typeName(uint16_t type);
+
+    static constexpr uint16_t minType = RTM_BASE;
+    static constexpr uint16_t maxType = RTM_MAX;
+
+  private:
+    std::array<Counters, maxType - minType + 1> counters;
+
+    Counters* find(uint16_t type) noexcept;
+};
+
+} // namespace phosphor::network::netlink
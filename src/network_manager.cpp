@@ -16,13 +16,15 @@
 #include <sdbusplus/message.hpp>
 #include <stdplus/numeric/str.hpp>
 #include <stdplus/pinned.hpp>
-#include <stdplus/print.hpp>
 #include <stdplus/str/cat.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <cassert>
+#include <chrono>
 #include <filesystem>
 #include <format>
-#include <fstream>
+#include <map>
+#include <utility>
 
 namespace phosphor
 {
@@ -57,6 +59,10 @@ Manager::Manager(stdplus::PinnedRef<sdbusplus::bus_t> bus,
                  const std::filesystem::path& confDir) :
     ManagerIface(bus, objPath.c_str(), ManagerIface::action::defer_emit),
     reload(reload), bus(bus), objPath(std::string(objPath)), confDir(confDir),
+    lldp(lldpFilePath, LLDPControl::lldpcli,
+         [self = stdplus::PinnedRef(*this)]() {
+             self.get().reloadLLDPService();
+         }),
 
     // D - Bus 信号监听与系统状态同步
     // 这段代码设置了一个 D-Bus 信号匹配器，用于监听 systemd-network1
@@ -104,6 +110,19 @@ Manager::Manager(stdplus::PinnedRef<sdbusplus::bus_t> bus,
     // 执行所有注册的 reloadPostHooks（重载后钩子函数）
     // 每次执行后清理钩子函数列表
     reload.get().setCallback([self = stdplus::PinnedRef(*this)]() {
+        // 重载前先把所有待写的配置文件各写一次
+        self.get().flushConfigs();
+        // 配置文件在语义上没有变化且没有待执行的钩子时，无需重载
+        // networkd 重载时只会重新配置其 .network 文件有变化的接口
+        // 标志只在重载成功后清除，重载失败时下一次调度仍会重载
+        bool changed = self.get().configsChanged || self.get().netdevsChanged;
+        if (!changed && self.get().reloadPreHooks.empty() &&
+            self.get().reloadPostHooks.empty())
+        {
+            self.get().reloadStats.avoided++;
+            lg2::debug("Skipped reloading systemd-networkd, nothing changed");
+            return;
+        }
         for (auto& hook : self.get().reloadPreHooks)
         {
             try
@@ -125,6 +144,9 @@ Manager::Manager(stdplus::PinnedRef<sdbusplus::bus_t> bus,
                                  "/org/freedesktop/network1",
                                  "org.freedesktop.network1.Manager", "Reload")
                 .call();
+            self.get().configsChanged = false;
+            self.get().netdevsChanged = false;
+            self.get().reloadStats.reloads++;
             lg2::info("Reloaded systemd-networkd");
         }
         catch (const sdbusplus::exception_t& ex)
@@ -147,49 +169,128 @@ Manager::Manager(stdplus::PinnedRef<sdbusplus::bus_t> bus,
         self.get().reloadPostHooks.clear();
     });
 
-    // 这段代码负责初始化时获取并处理所有当前网络接口的状态：
-    // 通过 D-Bus调用，ListLinks方法获取所有网络接口列表 对每个接口，构造其
-    //  D-Bus对象路径，调用Get方法获取接口的 AdministrativeState 属性
-    // 调用handleAdminState 方法处理接口状态 忽略 systemd-networkd
+    // 异步获取 systemd-networkd 中所有接口的 AdministrativeState，
+    // 不阻塞构造函数，netlink 驱动的接口创建可以同时进行
+    discoverAdminStates();
+
+    // 系统配置初始化
+    std::filesystem::create_directories(confDir);
+    // 系统配置config
+    // /xyz/openbmc_project/network
+    systemConf = std::make_unique<phosphor::network::SystemConfiguration>(
+        bus, (this->objPath / "config").str);
+}
+
+void Manager::discoverAdminStates()
+{
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        discoveryCalls.push_back(
+            bus.get()
+                .new_method_call("org.freedesktop.network1",
+                                 "/org/freedesktop/network1",
+                                 "org.freedesktop.network1.Manager",
+                                 "ListLinks")
+                .call_async([self = stdplus::PinnedRef(*this),
+                             start](sdbusplus::message_t& m) {
+                    self.get().handleLinkList(m, start);
+                }));
+    }
+    catch (const sdbusplus::exception::SdBusError& e)
+    {
+        // Any failures are systemd-network not being ready
+    }
+}
+
+void Manager::handleLinkList(sdbusplus::message_t& m,
+                             std::chrono::steady_clock::time_point start)
+{
     std::vector<
         std::tuple<int32_t, std::string, sdbusplus::message::object_path>>
         links;
     try
     {
-        auto rsp = bus.get()
-                       .new_method_call("org.freedesktop.network1",
-                                        "/org/freedesktop/network1",
-                                        "org.freedesktop.network1.Manager",
-                                        "ListLinks")
-                       .call();
-        rsp.read(links);
+        if (!m.is_method_error())
+        {
+            m.read(links);
+        }
     }
-    catch (const sdbusplus::exception::SdBusError& e)
+    catch (const std::exception& e)
     {
-        // Any failures are systemd-network not being ready
+        lg2::error("Failed to parse networkd links: {ERROR}", "ERROR", e);
     }
+    auto listed = std::chrono::steady_clock::now();
+    // Every Get is in flight at once so discovery costs a single round trip
+    // however many links there are
     for (const auto& link : links)
     {
         unsigned ifidx = std::get<0>(link);
         stdplus::ToStrHandle<stdplus::IntToStr<10, unsigned>> tsh;
         auto obj =
             stdplus::strCat("/org/freedesktop/network1/link/_3"sv, tsh(ifidx));
-        auto req =
-            bus.get().new_method_call("org.freedesktop.network1", obj.c_str(),
-                                      "org.freedesktop.DBus.Properties", "Get");
-        req.append("org.freedesktop.network1.Link", "AdministrativeState");
-        auto rsp = req.call();
-        std::variant<std::string> val;
-        rsp.read(val);
-        handleAdminState(std::get<std::string>(val), ifidx);
+        try
+        {
+            auto req = bus.get().new_method_call(
+                "org.freedesktop.network1", obj.c_str(),
+                "org.freedesktop.DBus.Properties", "Get");
+            req.append("org.freedesktop.network1.Link", "AdministrativeState");
+            discoveryCalls.push_back(req.call_async(
+                [self = stdplus::PinnedRef(*this), ifidx, start,
+                 listed](sdbusplus::message_t& m) {
+                    self.get().handleLinkState(m, ifidx, start, listed);
+                }));
+            discoveryPending++;
+        }
+        catch (const sdbusplus::exception::SdBusError& e)
+        {
+            lg2::error("Failed to query networkd link {IFIDX}: {ERROR}",
+                       "IFIDX", ifidx, "ERROR", e);
+        }
     }
+    if (discoveryPending == 0)
+    {
+        discoveryCalls.clear();
+    }
+}
 
-    // 系统配置初始化
-    std::filesystem::create_directories(confDir);
-    // 系统配置config
-    // /xyz/openbmc_project/network
-    systemConf = std::make_unique<phosphor::network::SystemConfiguration>(
-        bus, (this->objPath / "config").str);
+void Manager::handleLinkState(sdbusplus::message_t& m, unsigned ifidx,
+                              std::chrono::steady_clock::time_point start,
+                              std::chrono::steady_clock::time_point listed)
+{
+    try
+    {
+        if (m.is_method_error())
+        {
+            // The link went away since it was listed
+            lg2::debug("No networkd state for link {IFIDX}", "IFIDX", ifidx);
+        }
+        else
+        {
+            std::variant<std::string> val;
+            m.read(val);
+            handleAdminState(std::get<std::string>(val), ifidx);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to handle networkd link {IFIDX}: {ERROR}", "IFIDX",
+                   ifidx, "ERROR", e);
+    }
+    if (--discoveryPending > 0)
+    {
+        return;
+    }
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    auto done = std::chrono::steady_clock::now();
+    lg2::info("Discovered networkd link states in {TOTAL_US}us, listing "
+              "{LIST_US}us, {LINKS} states {STATE_US}us",
+              "TOTAL_US", duration_cast<microseconds>(done - start).count(),
+              "LIST_US", duration_cast<microseconds>(listed - start).count(),
+              "LINKS", discoveryCalls.size() - 1, "STATE_US",
+              duration_cast<microseconds>(done - listed).count());
+    discoveryCalls.clear();
 }
 
 //  主要负责创建或更新以太网接口对象
@@ -200,30 +301,32 @@ Manager::Manager(stdplus::PinnedRef<sdbusplus::bus_t> bus,
 //  enabled : 表示接口是否启用
 void Manager::createInterface(const AllIntfInfo& info, bool enabled)
 {
-    if (ignoredIntf.find(info.intf.idx) != ignoredIntf.end())
+    auto slot = intfs.find(info.intf.idx);
+    if (slot != nullptr && slot->ignored())
     {
         return;
     }
-    if (auto it = interfacesByIdx.find(info.intf.idx);
-        it != interfacesByIdx.end())
+    auto intf = slot != nullptr ? slot->intf : nullptr;
+    if (intf == nullptr && info.intf.name)
     {
-        if (info.intf.name && *info.intf.name != it->second->interfaceName())
-        {
-            interfaces.erase(it->second->interfaceName());
-            interfacesByIdx.erase(it);
-        }
-        else
+        // Objects made ahead of their link, like new VLANs, are only known
+        // by name until the kernel announces them
+        if (auto it = interfaces.find(*info.intf.name); it != interfaces.end())
         {
-            it->second->updateInfo(info.intf);
-            return;
+            intf = it->second.get();
         }
     }
-    else if (info.intf.name)
+    if (intf != nullptr)
     {
-        auto it = interfaces.find(*info.intf.name);
-        if (it != interfaces.end())
+        if (info.intf.name && *info.intf.name != intf->interfaceName())
         {
-            it->second->updateInfo(info.intf);
+            // The object path follows the name, so a rename recreates it
+            eraseIntf(*intf);
+        }
+        else
+        {
+            indexIntf(*intf, info.intf.idx);
+            intf->updateInfo(info.intf);
             return;
         }
     }
@@ -246,9 +349,81 @@ void Manager::createInterface(const AllIntfInfo& info, bool enabled)
 
     // 接口对象注册
     // 网络配置持久化与运行时状态管理之间的桥梁
-    auto ptr = intf.get();
-    interfaces.insert_or_assign(*info.intf.name, std::move(intf));
-    interfacesByIdx.insert_or_assign(info.intf.idx, ptr);
+    insertIntf(std::move(intf));
+}
+
+EthernetInterface&
+    Manager::insertIntf(std::unique_ptr<EthernetInterface>&& intf)
+{
+    auto& ret = *intf;
+    if (auto it = interfaces.find(ret.interfaceName()); it != interfaces.end())
+    {
+        eraseIntf(*it->second);
+    }
+    interfaces.emplace(ret.interfaceName(), std::move(intf));
+    if (ret.getIfIdx() > 0)
+    {
+        intfs.slot(ret.getIfIdx()).intf = &ret;
+    }
+    checkIntf(ret);
+    return ret;
+}
+
+std::unique_ptr<EthernetInterface> Manager::eraseIntf(EthernetInterface& intf)
+{
+    checkIntf(intf);
+    if (auto slot = intfs.find(intf.getIfIdx());
+        slot != nullptr && slot->intf == &intf)
+    {
+        slot->intf = nullptr;
+    }
+    auto it = interfaces.find(intf.interfaceName());
+    if (it == interfaces.end() || it->second.get() != &intf)
+    {
+        lg2::error("Interface {NET_INTF} missing from the name index",
+                   "NET_INTF", intf.interfaceName());
+        return nullptr;
+    }
+    auto ret = std::move(it->second);
+    interfaces.erase(it);
+    return ret;
+}
+
+void Manager::indexIntf(EthernetInterface& intf, unsigned ifidx)
+{
+    if (intf.getIfIdx() == ifidx)
+    {
+        return;
+    }
+    if (auto slot = intfs.find(intf.getIfIdx());
+        slot != nullptr && slot->intf == &intf)
+    {
+        slot->intf = nullptr;
+    }
+    if (ifidx > 0)
+    {
+        intfs.slot(ifidx).intf = &intf;
+    }
+}
+
+void Manager::ignoreIntf(unsigned ifidx)
+{
+    intfs.setIgnored(ifidx, true);
+    auto& slot = intfs.slot(ifidx);
+    slot.info.reset();
+    if (slot.intf != nullptr)
+    {
+        eraseIntf(*slot.intf);
+    }
+}
+
+void Manager::checkIntf([[maybe_unused]] const EthernetInterface& intf) const
+{
+#ifndef NDEBUG
+    auto it = interfaces.find(intf.interfaceName());
+    assert(it != interfaces.end() && it->second.get() == &intf);
+    assert(intf.getIfIdx() == 0 || intfs.intf(intf.getIfIdx()) == &intf);
+#endif
 }
 
 // 负责根据接口信息决定是否创建和管理网络接口，并在系统中维护接口状态
@@ -257,7 +432,7 @@ void Manager::addInterface(const InterfaceInfo& info)
     // 接口类型过滤
     if (info.type != ARPHRD_ETHER)
     {
-        ignoredIntf.emplace(info.idx);
+        ignoreIntf(info.idx);
         return;
     }
     // 接口名称过滤
@@ -273,73 +448,62 @@ void Manager::addInterface(const InterfaceInfo& info)
                 lg2::info("Ignoring interface {NET_INTF}", "NET_INTF",
                           *info.name);
             }
-            ignoredIntf.emplace(info.idx);
+            ignoreIntf(info.idx);
             return;
         }
     }
 
     // 接口信息更新或创建
-    auto infoIt = intfInfo.find(info.idx);
-    if (infoIt != intfInfo.end())
+    auto& slot = intfs.slot(info.idx);
+    if (slot.info)
     {
         // 找到了接口信息，更新接口信息
-        infoIt->second.intf = info;
+        slot.info->intf = info;
     }
     else
     {
         // 未找到接口信息，创建新的接口信息
-        infoIt = std::get<0>(intfInfo.emplace(info.idx, AllIntfInfo{info}));
+        slot.info = std::make_unique<AllIntfInfo>(AllIntfInfo{info});
     }
 
     // 接口创建决策
-    if (auto it = systemdNetworkdEnabled.find(info.idx);
-        it != systemdNetworkdEnabled.end())
+    if (slot.enabled)
     {
-        // 该接口在 systemdNetworkdEnabled
-        // 映射中，创建以太网接口对象，传入完整的接口信息和启用状态
-        createInterface(infoIt->second, it->second);
+        // systemd-networkd 已报告该接口的状态，创建以太网接口对象，
+        // 传入完整的接口信息和启用状态
+        createInterface(*slot.info, *slot.enabled);
     }
 }
 
 void Manager::removeInterface(const InterfaceInfo& info)
 {
-    auto iit = interfacesByIdx.find(info.idx);
-    auto nit = interfaces.end();
+    EthernetInterface* intf = nullptr;
+    if (auto slot = intfs.find(info.idx); slot != nullptr)
+    {
+        slot->info.reset();
+        intf = slot->intf;
+    }
+    intfs.setIgnored(info.idx, false);
     if (info.name)
     {
-        nit = interfaces.find(*info.name);
-        if (nit != interfaces.end() && iit != interfacesByIdx.end() &&
-            nit->second.get() != iit->second)
+        auto it = interfaces.find(*info.name);
+        auto named = it != interfaces.end() ? it->second.get() : nullptr;
+        assert(intf == nullptr || named == nullptr || named == intf);
+        if (intf == nullptr)
         {
-            stdplus::print(stderr, "Removed interface desync detected\n");
-            fflush(stderr);
-            std::abort();
+            intf = named;
         }
-    }
-    else if (iit != interfacesByIdx.end())
-    {
-        for (nit = interfaces.begin(); nit != interfaces.end(); ++nit)
+        else if (named != nullptr && named != intf)
         {
-            if (nit->second.get() == iit->second)
-            {
-                break;
-            }
+            lg2::error("Removed interface desync detected for {NET_INTF}",
+                       "NET_INTF", *info.name);
+            eraseIntf(*named);
         }
     }
-
-    if (iit != interfacesByIdx.end())
-    {
-        interfacesByIdx.erase(iit);
-    }
-    else
-    {
-        ignoredIntf.erase(info.idx);
-    }
-    if (nit != interfaces.end())
+    if (intf != nullptr)
     {
-        interfaces.erase(nit);
+        eraseIntf(*intf);
     }
-    intfInfo.erase(info.idx);
 }
 
 void Manager::addAddress(const AddressInfo& info)
@@ -348,16 +512,16 @@ void Manager::addAddress(const AddressInfo& info)
     {
         return;
     }
-    if (auto it = intfInfo.find(info.ifidx); it != intfInfo.end())
+    auto slot = intfs.find(info.ifidx);
+    if (slot != nullptr && slot->info)
     {
-        it->second.addrs.insert_or_assign(info.ifaddr, info);
-        if (auto it = interfacesByIdx.find(info.ifidx);
-            it != interfacesByIdx.end())
+        slot->info->addrs.insert_or_assign(info.ifaddr, info);
+        if (slot->intf != nullptr)
         {
-            it->second->addAddr(info);
+            slot->intf->addAddr(info);
         }
     }
-    else if (!ignoredIntf.contains(info.ifidx))
+    else if (slot == nullptr || !slot->ignored())
     {
         throw std::runtime_error(
             std::format("Interface `{}` not found for addr", info.ifidx));
@@ -366,12 +530,13 @@ void Manager::addAddress(const AddressInfo& info)
 
 void Manager::removeAddress(const AddressInfo& info)
 {
-    if (auto it = interfacesByIdx.find(info.ifidx); it != interfacesByIdx.end())
+    auto slot = intfs.find(info.ifidx);
+    if (slot != nullptr && slot->intf != nullptr)
     {
-        it->second->addrs.erase(info.ifaddr);
-        if (auto it = intfInfo.find(info.ifidx); it != intfInfo.end())
+        slot->intf->addrs.erase(info.ifaddr);
+        if (slot->info)
         {
-            it->second.addrs.erase(info.ifaddr);
+            slot->info->addrs.erase(info.ifaddr);
         }
     }
 }
@@ -382,16 +547,16 @@ void Manager::addNeighbor(const NeighborInfo& info)
     {
         return;
     }
-    if (auto it = intfInfo.find(info.ifidx); it != intfInfo.end())
+    auto slot = intfs.find(info.ifidx);
+    if (slot != nullptr && slot->info)
     {
-        it->second.staticNeighs.insert_or_assign(*info.addr, info);
-        if (auto it = interfacesByIdx.find(info.ifidx);
-            it != interfacesByIdx.end())
+        slot->info->staticNeighs.insert_or_assign(*info.addr, info);
+        if (slot->intf != nullptr)
         {
-            it->second->addStaticNeigh(info);
+            slot->intf->addStaticNeigh(info);
         }
     }
-    else if (!ignoredIntf.contains(info.ifidx))
+    else if (slot == nullptr || !slot->ignored())
     {
         throw std::runtime_error(
             std::format("Interface `{}` not found for neigh", info.ifidx));
@@ -404,57 +569,59 @@ void Manager::removeNeighbor(const NeighborInfo& info)
     {
         return;
     }
-    if (auto it = intfInfo.find(info.ifidx); it != intfInfo.end())
+    auto slot = intfs.find(info.ifidx);
+    if (slot != nullptr && slot->info)
     {
-        it->second.staticNeighs.erase(*info.addr);
-        if (auto it = interfacesByIdx.find(info.ifidx);
-            it != interfacesByIdx.end())
+        slot->info->staticNeighs.erase(*info.addr);
+        if (slot->intf != nullptr)
         {
-            it->second->staticNeighbors.erase(*info.addr);
+            slot->intf->staticNeighbors.erase(*info.addr);
         }
     }
 }
 
 void Manager::addDefGw(unsigned ifidx, stdplus::InAnyAddr addr)
 {
-    if (auto it = intfInfo.find(ifidx); it != intfInfo.end())
+    auto slot = intfs.find(ifidx);
+    if (slot != nullptr && slot->info)
     {
+        auto& info = *slot->info;
         std::visit(
             [&](auto addr) {
                 if constexpr (std::is_same_v<stdplus::In4Addr, decltype(addr)>)
                 {
-                    it->second.defgw4.emplace(addr);
+                    info.defgw4.emplace(addr);
                 }
                 else
                 {
                     static_assert(
                         std::is_same_v<stdplus::In6Addr, decltype(addr)>);
-                    it->second.defgw6.emplace(addr);
+                    info.defgw6.emplace(addr);
                 }
             },
             addr);
-        if (auto it = interfacesByIdx.find(ifidx); it != interfacesByIdx.end())
+        if (auto intf = slot->intf; intf != nullptr)
         {
             std::visit(
                 [&](auto addr) {
                     if constexpr (std::is_same_v<stdplus::In4Addr,
                                                  decltype(addr)>)
                     {
-                        it->second->EthernetInterfaceIntf::defaultGateway(
+                        intf->EthernetInterfaceIntf::defaultGateway(
                             stdplus::toStr(addr));
                     }
                     else
                     {
                         static_assert(
                             std::is_same_v<stdplus::In6Addr, decltype(addr)>);
-                        it->second->EthernetInterfaceIntf::defaultGateway6(
+                        intf->EthernetInterfaceIntf::defaultGateway6(
                             stdplus::toStr(addr));
                     }
                 },
                 addr);
         }
     }
-    else if (!ignoredIntf.contains(ifidx))
+    else if (slot == nullptr || !slot->ignored())
     {
         lg2::error("Interface {NET_IDX} not found for gw", "NET_IDX", ifidx);
     }
@@ -462,29 +629,31 @@ void Manager::addDefGw(unsigned ifidx, stdplus::InAnyAddr addr)
 
 void Manager::removeDefGw(unsigned ifidx, stdplus::InAnyAddr addr)
 {
-    if (auto it = intfInfo.find(ifidx); it != intfInfo.end())
+    auto slot = intfs.find(ifidx);
+    if (slot != nullptr && slot->info)
     {
+        auto& info = *slot->info;
         std::visit(
             [&](auto addr) {
                 if constexpr (std::is_same_v<stdplus::In4Addr, decltype(addr)>)
                 {
-                    if (it->second.defgw4 == addr)
+                    if (info.defgw4 == addr)
                     {
-                        it->second.defgw4.reset();
+                        info.defgw4.reset();
                     }
                 }
                 else
                 {
                     static_assert(
                         std::is_same_v<stdplus::In6Addr, decltype(addr)>);
-                    if (it->second.defgw6 == addr)
+                    if (info.defgw6 == addr)
                     {
-                        it->second.defgw6.reset();
+                        info.defgw6.reset();
                     }
                 }
             },
             addr);
-        if (auto it = interfacesByIdx.find(ifidx); it != interfacesByIdx.end())
+        if (auto intf = slot->intf; intf != nullptr)
         {
             std::visit(
                 [&](auto addr) {
@@ -493,10 +662,9 @@ void Manager::removeDefGw(unsigned ifidx, stdplus::InAnyAddr addr)
                     {
                         stdplus::ToStrHandle<stdplus::ToStr<stdplus::In4Addr>>
                             tsh;
-                        if (it->second->defaultGateway() == tsh(addr))
+                        if (intf->defaultGateway() == tsh(addr))
                         {
-                            it->second->EthernetInterfaceIntf::defaultGateway(
-                                "");
+                            intf->EthernetInterfaceIntf::defaultGateway("");
                         }
                     }
                     else
@@ -505,10 +673,9 @@ void Manager::removeDefGw(unsigned ifidx, stdplus::InAnyAddr addr)
                             std::is_same_v<stdplus::In6Addr, decltype(addr)>);
                         stdplus::ToStrHandle<stdplus::ToStr<stdplus::In6Addr>>
                             tsh;
-                        if (it->second->defaultGateway6() == tsh(addr))
+                        if (intf->defaultGateway6() == tsh(addr))
                         {
-                            it->second->EthernetInterfaceIntf::defaultGateway6(
-                                "");
+                            intf->EthernetInterfaceIntf::defaultGateway6("");
                         }
                     }
                 },
@@ -517,6 +684,115 @@ void Manager::removeDefGw(unsigned ifidx, stdplus::InAnyAddr addr)
     }
 }
 
+size_t Manager::reconcile(
+    const std::unordered_map<unsigned, AllIntfInfo>& state)
+{
+    size_t changes = 0;
+
+    std::vector<InterfaceInfo> gone;
+    intfs.forEach([&](unsigned idx, IntfTable::Slot& slot) {
+        if (slot.info && !state.contains(idx))
+        {
+            gone.push_back(slot.info->intf);
+        }
+    });
+    for (const auto& intf : gone)
+    {
+        removeInterface(intf);
+        changes++;
+    }
+    for (auto idx : intfs.ignoredIntfs())
+    {
+        if (!state.contains(idx))
+        {
+            intfs.setIgnored(idx, false);
+            changes++;
+        }
+    }
+
+    for (const auto& [idx, info] : state)
+    {
+        auto cur = intfs.info(idx);
+        if (cur == nullptr ? !intfs.ignored(idx) : !(cur->intf == info.intf))
+        {
+            addInterface(info.intf);
+            changes++;
+            cur = intfs.info(idx);
+        }
+        if (cur == nullptr)
+        {
+            continue;
+        }
+
+        std::vector<AddressInfo> oldAddrs;
+        for (const auto& [addr, ainfo] : cur->addrs)
+        {
+            if (!info.addrs.contains(addr))
+            {
+                oldAddrs.push_back(ainfo);
+            }
+        }
+        for (const auto& ainfo : oldAddrs)
+        {
+            removeAddress(ainfo);
+            cur->addrs.erase(ainfo.ifaddr);
+            changes++;
+        }
+        for (const auto& [addr, ainfo] : info.addrs)
+        {
+            auto ait = cur->addrs.find(addr);
+            if (ait == cur->addrs.end() || !(ait->second == ainfo))
+            {
+                addAddress(ainfo);
+                changes++;
+            }
+        }
+
+        std::vector<NeighborInfo> oldNeighs;
+        for (const auto& [addr, ninfo] : cur->staticNeighs)
+        {
+            if (!info.staticNeighs.contains(addr))
+            {
+                oldNeighs.push_back(ninfo);
+            }
+        }
+        for (const auto& ninfo : oldNeighs)
+        {
+            removeNeighbor(ninfo);
+            changes++;
+        }
+        for (const auto& [addr, ninfo] : info.staticNeighs)
+        {
+            auto nit = cur->staticNeighs.find(addr);
+            if (nit == cur->staticNeighs.end() || !(nit->second == ninfo))
+            {
+                addNeighbor(ninfo);
+                changes++;
+            }
+        }
+
+        // Taken by value as removing the gateway resets the tracked copy
+        auto syncGw = [&](auto have, const auto& want) {
+            if (have == want)
+            {
+                return;
+            }
+            if (have)
+            {
+                removeDefGw(idx, *have);
+            }
+            if (want)
+            {
+                addDefGw(idx, *want);
+            }
+            changes++;
+        };
+        syncGw(cur->defgw4, info.defgw4);
+        syncGw(cur->defgw6, info.defgw6);
+    }
+    return changes;
+}
+
 ObjectPath Manager::vlan(std::string interfaceName, uint32_t id)
 {
     if (id == 0 || id >= 4095)
@@ -544,6 +820,8 @@ void Manager::reset()
         std::error_code ec;
         std::filesystem::remove(dirent.path(), ec);
     }
+    // 丢弃尚未写入的修改，避免清除后又被重新写回
+    dirtyConfigs.clear();
     lg2::info("Network data purged.");
 }
 
@@ -554,6 +832,45 @@ void Manager::writeToConfigurationFile()
     {
         intf.second->writeConfigurationFile();
     }
+    dirtyConfigs.clear();
+}
+
+void Manager::queueConfigFlush(std::string_view ifname)
+{
+    dirtyConfigs.emplace(ifname);
+}
+
+size_t Manager::flushConfigs()
+{
+    size_t written = 0;
+    for (const auto& ifname : dirtyConfigs)
+    {
+        // 接口可能在排队后已被删除
+        auto it = interfaces.find(ifname);
+        if (it == interfaces.end())
+        {
+            continue;
+        }
+        try
+        {
+            if (it->second->writeConfigurationFile())
+            {
+                written++;
+            }
+            else
+            {
+                reloadStats.unchangedWrites++;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Failed to write config for {NET_INTF}: {ERROR}",
+                       "NET_INTF", ifname, "ERROR", e);
+        }
+    }
+    dirtyConfigs.clear();
+    configsChanged = configsChanged || written > 0;
+    return written;
 }
 
 // 接收网络接口的管理状态字符串和接口索引，根据不同的状态值执行相应的操作，主要用于维护
@@ -562,22 +879,25 @@ void Manager::handleAdminState(std::string_view state, unsigned ifidx)
 {
     if (state == "initialized" || state == "linger")
     {
-        systemdNetworkdEnabled.erase(ifidx);
+        if (auto slot = intfs.find(ifidx); slot != nullptr)
+        {
+            slot->enabled.reset();
+        }
     }
     else
     {
         bool managed = state != "unmanaged";
-        systemdNetworkdEnabled.insert_or_assign(ifidx, managed);
-        if (auto it = intfInfo.find(ifidx); it != intfInfo.end())
+        intfs.slot(ifidx).enabled = managed;
+        if (auto info = intfs.info(ifidx); info != nullptr)
         {
             if (exist config)
             {
                 // 修改it->second == AllIntfInfo，根据配置文件
                 // --- 根据配置文件创建接口 ---
-                AllIntfInfo& tmp = it->second;
+                AllIntfInfo& tmp = *info;
                 tmp.inf
                 
-                createInterface(it->second, managed);
+                createInterface(*info, managed);
                 // 写配置重新加载
                 // 如果存在配置文件
                 writeConfigurationFile();
@@ -585,34 +905,30 @@ void Manager::handleAdminState(std::string_view state, unsigned ifidx)
             }
             else
             {
-                createInterface(it->second, managed);
+                createInterface(*info, managed);
             }
         }
     }
 }
 
-void Manager::writeLLDPDConfigurationFile()
+std::map<std::string, bool> Manager::lldpPorts() const
 {
-    std::ofstream lldpdConfig(lldpFilePath);
-
-    lldpdConfig << "configure system description BMC" << std::endl;
-    lldpdConfig << "configure system ip management pattern eth*" << std::endl;
-    for (const auto& intf : interfaces)
+    std::map<std::string, bool> ports;
+    for (const auto& [name, intf] : interfaces)
     {
-        bool emitlldp = intf.second->emitLLDP();
-        if (emitlldp)
-        {
-            lldpdConfig << "configure ports " << intf.second->interfaceName()
-                        << " lldp status tx-only" << std::endl;
-        }
-        else
-        {
-            lldpdConfig << "configure ports " << intf.second->interfaceName()
-                        << " lldp status disabled" << std::endl;
-        }
+        ports.emplace(name, intf->emitLLDP());
     }
+    return ports;
+}
+
+void Manager::writeLLDPDConfigurationFile()
+{
+    lldp.persist(lldpPorts());
+}
 
-    lldpdConfig.close();
+void Manager::setLLDPStatus(std::string_view ifname)
+{
+    lldp.apply(lldpPorts(), ifname);
 }
 
 void Manager::reloadLLDPService()
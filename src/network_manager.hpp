@@ -1,6 +1,8 @@
 #pragma once
 #include "dhcp_configuration.hpp"
 #include "ethernet_interface.hpp"
+#include "intf_table.hpp"
+#include "lldp_control.hpp"
 #include "system_configuration.hpp"
 #include "types.hpp"
 #include "xyz/openbmc_project/Network/VLAN/Create/server.hpp"
@@ -8,16 +10,21 @@
 #include <function2/function2.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
 #include <sdbusplus/message/native_types.hpp>
+#include <sdbusplus/slot.hpp>
 #include <stdplus/pinned.hpp>
 #include <stdplus/str/maps.hpp>
 #include <stdplus/zstring_view.hpp>
 #include <xyz/openbmc_project/Common/FactoryReset/server.hpp>
 
+#include <chrono>
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 #include <vector>
 
 namespace phosphor
@@ -55,14 +62,83 @@ class Manager : public ManagerIface
      */
     void writeToConfigurationFile();
 
+    /** @brief Queues the network conf file of an interface to be written
+     *         by the next flush
+     *
+     *  @param[in] ifname - The name of the interface
+     */
+    void queueConfigFlush(std::string_view ifname);
+
+    /** @brief Writes every queued network conf file once
+     *
+     *  @return The number of files that changed
+     */
+    size_t flushConfigs();
+
+    /** @brief Notes that a .netdev file was added or removed, which
+     *         networkd only picks up on a reload
+     */
+    inline void markNetdevChanged() noexcept
+    {
+        netdevsChanged = true;
+    }
+
+    /** @brief Counters describing how often networkd had to be reloaded */
+    struct ReloadStats
+    {
+        /** @brief Reloads sent to networkd */
+        size_t reloads = 0;
+        /** @brief Scheduled reloads dropped as nothing had changed */
+        size_t avoided = 0;
+        /** @brief Queued writes dropped as the file would not change */
+        size_t unchangedWrites = 0;
+        /** @brief Network conf files written by any interface */
+        size_t configWrites = 0;
+    };
+
+    /** @brief Gets the reload counters */
+    inline const ReloadStats& getReloadStats() const noexcept
+    {
+        return reloadStats;
+    }
+
+    /** @brief Notes that an interface wrote its network conf file */
+    inline void countConfigWrite() noexcept
+    {
+        reloadStats.configWrites++;
+    }
+
     /** @brief write the lldp conf file
      */
     void writeLLDPDConfigurationFile();
 
+    /** @brief Applies the LLDP status of an interface to lldpd and
+     *         persists it
+     *
+     *  @param[in] ifname - The interface whose status changed
+     */
+    void setLLDPStatus(std::string_view ifname);
+
     /** @brief Adds a single interface to the interface map */
     void addInterface(const InterfaceInfo& info);
     void removeInterface(const InterfaceInfo& info);
 
+    /** @brief Adds an interface object to the name and ifindex indexes,
+     *         replacing any object of the same name
+     */
+    EthernetInterface& insertIntf(std::unique_ptr<EthernetInterface>&& intf);
+
+    /** @brief Removes an interface object from every index
+     *
+     *  @return The object, which leaves the bus once destroyed
+     */
+    std::unique_ptr<EthernetInterface> eraseIntf(EthernetInterface& intf);
+
+    /** @brief Drops everything known about an interface and ignores its
+     *         events until the kernel removes it
+     */
+    void ignoreIntf(unsigned ifidx);
+
     /** @brief Add / remove an address to the interface or queue */
     void addAddress(const AddressInfo& info);
     void removeAddress(const AddressInfo& info);
@@ -75,6 +151,23 @@ class Manager : public ManagerIface
     void addDefGw(unsigned ifidx, stdplus::InAnyAddr addr);
     void removeDefGw(unsigned ifidx, stdplus::InAnyAddr addr);
 
+    /** @brief Whether the kernel has announced the interface, even if it
+     *         is ignored or not yet on the bus
+     */
+    inline bool hasIntf(unsigned ifidx) const
+    {
+        auto s = intfs.find(ifidx);
+        return s != nullptr && (s->info || s->ignored());
+    }
+
+    /** @brief Brings the tracked state in line with a fresh dump of the
+     *         kernel, only adding or removing what actually differs
+     *
+     *  @param[in] state - The complete kernel state keyed by ifindex
+     *  @return The number of changes applied
+     */
+    size_t reconcile(const std::unordered_map<unsigned, AllIntfInfo>& state);
+
     /** @brief gets the network conf directory.
      */
     inline const auto& getConfDir() const
@@ -115,8 +208,12 @@ class Manager : public ManagerIface
     /** @brief Persistent map of EthernetInterface dbus objects and their names
      */
     stdplus::string_umap<std::unique_ptr<EthernetInterface>> interfaces;
-    std::unordered_map<unsigned, EthernetInterface*> interfacesByIdx;
-    std::unordered_set<unsigned> ignoredIntf;
+
+    /** @brief Per ifindex state: the bus object, the kernel state of
+     *         undiscovered interfaces, the networkd state and whether the
+     *         interface is ignored
+     */
+    IntfTable intfs;
 
     /** @brief Adds a hook that runs immediately prior to reloading
      *
@@ -154,22 +251,60 @@ class Manager : public ManagerIface
     /** @brief Network Configuration directory. */
     std::filesystem::path confDir;
 
-    /** @brief Map of interface info for undiscovered interfaces */
-    std::unordered_map<unsigned, AllIntfInfo> intfInfo;
+    /** @brief Applies LLDP changes to lldpd */
+    LLDPControl lldp;
 
-    /** @brief Map of enabled interfaces */
-    std::unordered_map<unsigned, bool> systemdNetworkdEnabled;
     sdbusplus::bus::match_t systemdNetworkdEnabledMatch;
 
+    /** @brief Interfaces whose network conf file is out of date */
+    std::unordered_set<std::string> dirtyConfigs;
+
+    /** @brief Whether any file networkd reads changed since the last
+     *         reload
+     */
+    bool configsChanged = false;
+    bool netdevsChanged = false;
+
+    ReloadStats reloadStats;
+
     /** @brief List of hooks to execute during the next reload */
     std::vector<fu2::unique_function<void()>> reloadPreHooks;
     std::vector<fu2::unique_function<void()>> reloadPostHooks;
 
+    /** @brief The LLDP status of every interface */
+    std::map<std::string, bool> lldpPorts() const;
+
     /** @brief Handles the receipt of an administrative state string */
     void handleAdminState(std::string_view state, unsigned ifidx);
 
+    /** @brief Outstanding calls learning the networkd link states */
+    std::vector<sdbusplus::slot_t> discoveryCalls;
+    size_t discoveryPending = 0;
+
+    /** @brief Asks networkd for the state of every link without waiting
+     *         for the replies
+     */
+    void discoverAdminStates();
+
+    /** @brief Handles the ListLinks reply by querying every link at once */
+    void handleLinkList(sdbusplus::message_t& m,
+                        std::chrono::steady_clock::time_point start);
+
+    /** @brief Handles the AdministrativeState reply of a single link */
+    void handleLinkState(sdbusplus::message_t& m, unsigned ifidx,
+                         std::chrono::steady_clock::time_point start,
+                         std::chrono::steady_clock::time_point listed);
+
     /** @brief Creates the interface in the maps */
     void createInterface(const AllIntfInfo& info, bool enabled);
+
+    /** @brief Moves an object to the slot of a newly learned ifindex */
+    void indexIntf(EthernetInterface& intf, unsigned ifidx);
+
+    /** @brief Asserts in debug builds that an object is indexed under both
+     *         its name and its ifindex
+     */
+    void checkIntf(const EthernetInterface& intf) const;
 };
 
 } // namespace network
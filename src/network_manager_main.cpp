@@ -3,7 +3,13 @@
 #ifdef SYNC_MAC_FROM_INVENTORY
 #include "inventory_mac.hpp"
 #endif
+#include "link_stats_debug.hpp"
+#include "neighbor_debug.hpp"
+#include "netlink_debug.hpp"
 #include "network_manager.hpp"
+#include "reload_debug.hpp"
+#include "reload_policy.hpp"
+#include "route_debug.hpp"
 #include "rtnetlink_server.hpp"
 #include "types.hpp"
 
@@ -19,7 +25,9 @@
 #include <stdplus/print.hpp>
 #include <stdplus/signal.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <optional>
 
 constexpr char DEFAULT_OBJPATH[] = "/xyz/openbmc_project/network";
 
@@ -32,23 +40,37 @@ class TimerExecutor : public DelayedExecutor
     using Timer = sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>;
 
   public:
-    TimerExecutor(sdeventplus::Event& event, std::chrono::milliseconds delay) :
-        delay(delay), timer(event, nullptr)
+    TimerExecutor(sdeventplus::Event& event,
+                  const ReloadPolicy::Config& cfg) :
+        policy(cfg), timer(event, nullptr)
     {}
 
     void schedule() override
     {
-        // 当定时器到达指定延迟时间后，会触发通过 setCallback 方法设置的回调函数
-        timer.restartOnce(delay);
+        // 单独的修改很快生效；连续的修改在安静窗口内合并成一批，
+        // 但一批最多等待 maxLatency，避免持续修改使重载一直推迟
+        // 截止时间可能已经过去（例如事件循环被阻塞），此时立即触发
+        auto now = ReloadPolicy::Clock::now();
+        auto delay = std::max(policy.schedule(now) - now,
+                              ReloadPolicy::Clock::duration::zero());
+        timer.restartOnce(std::chrono::ceil<std::chrono::microseconds>(delay));
     }
 
     void setCallback(fu2::unique_function<void()>&& cb) override
     {
-        timer.set_callback([cb = std::move(cb)](Timer&) mutable { cb(); });
+        timer.set_callback([this, cb = std::move(cb)](Timer&) mutable {
+            policy.executed(ReloadPolicy::Clock::now());
+            cb();
+        });
+    }
+
+    inline const ReloadPolicy& getPolicy() const noexcept
+    {
+        return policy;
     }
 
   private:
-    std::chrono::milliseconds delay;
+    ReloadPolicy policy;
     Timer timer;
 };
 
@@ -77,6 +99,10 @@ int main()
     // 这对于需要稳定地址的回调和引用非常重要
     stdplus::Pinned bus = sdbusplus::bus::new_default();
 
+    // 记录启动各阶段的耗时
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
     // 创建DBus对象管理器，管理指定路径下的所有DBus对象
     // DEFAULT_OBJPATH定义为"/xyz/openbmc_project/network"
     // 对象管理器的创建标志着DBus服务框架的初始化完成
@@ -84,14 +110,20 @@ int main()
     sdbusplus::server::manager_t objManager(bus, DEFAULT_OBJPATH);
 
     // 创建定时器执行器，用于延迟执行任务（如配置重载）
-    // 延迟时间设置为3秒
+    // 延迟时间由 ReloadPolicy 按修改的节奏决定：
+    // - 安静一段时间后的单独修改在250毫秒后重载
+    // - 之后的每次修改把这一批推迟到1秒内再无修改为止
+    // - 一批从第一次修改算起最多等待3秒，持续的修改不会无限推迟重载
     // TimerExecutor是一个自定义类，继承自DelayedExecutor接口
     // 它封装了sdeventplus的定时器功能，提供了schedule()和setCallback()方法
     // 这种设计模式允许Manager类通过接口而非具体实现来使用定时器功能
     // 提高了代码的可测试性和灵活性
     // 定时器执行器在配置更改后提供延迟执行机制
-    // 这对于批量处理配置更改非常有用，可以避免频繁的系统调用
-    stdplus::Pinned<TimerExecutor> reload(event, std::chrono::seconds(3));
+    // 连续的配置更改合并成一次重载，同时单独的更改也能很快生效
+    stdplus::Pinned<TimerExecutor> reload(
+        event, ReloadPolicy::Config{.initial = std::chrono::milliseconds(250),
+                                    .window = std::chrono::seconds(1),
+                                    .maxLatency = std::chrono::seconds(3)});
 
     // 创建网络管理器的主对象，这是整个网络管理的核心组件
     // 参数包括：
@@ -102,17 +134,61 @@ int main()
     // Manager类负责管理所有网络接口、地址、路由和配置
     stdplus::Pinned<Manager> manager(bus, reload, DEFAULT_OBJPATH,
                                      "/etc/systemd/network");
+    auto managerDone = Clock::now();
 
     // 创建netlink服务器，用于与Linux内核网络子系统通信
     // 监听网络事件并通知manager处理
     // 这是连接用户空间和内核空间网络功能的桥梁
     netlink::Server svr(event, manager);
+    auto netlinkDone = Clock::now();
+
+    // 在同一路径上导出 netlink 消息处理和读取线程队列的调试计数器
+    NetlinkDebug netlinkDebug(bus, DEFAULT_OBJPATH,
+                              netlink::Server::getMessageStats(),
+                              [&svr] { return svr.getReaderStats(); });
+
+    // 导出重载的合并情况和延迟统计
+    ReloadDebug reloadDebug(bus, DEFAULT_OBJPATH, reload.getPolicy(), manager);
+
+    // 启用路由缓存时，提供路由查询接口
+    std::optional<RouteDebug> routeDebug;
+    if (auto routes = netlink::Server::getRouteTable(); routes != nullptr)
+    {
+        routeDebug.emplace(bus, DEFAULT_OBJPATH, *routes, manager);
+    }
+
+    // 启用邻居缓存时，提供批量查询接口，变化通知经过限速
+    std::optional<NeighborDebug> neighborDebug;
+    if (auto neighs = netlink::Server::getNeighborTable(); neighs != nullptr)
+    {
+        neighborDebug.emplace(bus, DEFAULT_OBJPATH, event, *neighs, manager);
+    }
+
+    // 定期通过一次 netlink dump 采样所有接口的流量计数
+    std::optional<LinkStatsDebug> linkStats;
+    if (LINK_STATS_INTERVAL > 0)
+    {
+        linkStats.emplace(bus, DEFAULT_OBJPATH, event,
+                          std::chrono::seconds(LINK_STATS_INTERVAL), manager);
+    }
 
 #ifdef SYNC_MAC_FROM_INVENTORY
     auto runtime = inventory::watch(bus, manager);
 #endif
 
     bus.request_name(DEFAULT_BUSNAME);
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    auto ready = Clock::now();
+    lg2::info("Started in {TOTAL_US}us, manager {MANAGER_US}us, netlink "
+              "{NETLINK_US}us, rest {REST_US}us",
+              "TOTAL_US", duration_cast<microseconds>(ready - start).count(),
+              "MANAGER_US",
+              duration_cast<microseconds>(managerDone - start).count(),
+              "NETLINK_US",
+              duration_cast<microseconds>(netlinkDone - managerDone).count(),
+              "REST_US",
+              duration_cast<microseconds>(ready - netlinkDone).count());
     return sdeventplus::utility::loopWithBus(event, bus);
 }
 
@@ -0,0 +1,41 @@
+#include "reload_debug.hpp"
+
+#include "network_manager.hpp"
+
+#include <chrono>
+
+namespace phosphor
+{
+namespace network
+{
+
+ReloadDebug::ReloadDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+                         const ReloadPolicy& policy, const Manager& manager) :
+    ReloadDebugObj(bus, objPath.c_str(),
+                   ReloadDebugObj::action::emit_interface_added),
+    policy(policy), manager(manager)
+{}
+
+std::map<std::string, uint64_t> ReloadDebug::getReloadStats()
+{
+    auto us = [](ReloadPolicy::Clock::duration d) -> uint64_t {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d)
+            .count();
+    };
+    const auto& p = policy.getStats();
+    const auto& m = manager.getReloadStats();
+    return {
+        {"Scheduled", p.scheduled},
+        {"Executed", p.executed},
+        {"LatencyLastUs", us(p.lastLatency)},
+        {"LatencyMaxUs", us(p.maxLatency)},
+        {"LatencyTotalUs", us(p.totalLatency)},
+        {"Reloads", m.reloads},
+        {"ReloadsAvoided", m.avoided},
+        {"UnchangedWrites", m.unchangedWrites},
+        {"ConfigWrites", m.configWrites},
+    };
+}
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,48 @@
+#pragma once
+#include "reload_policy.hpp"
+#include "xyz/openbmc_project/Network/Debug/Reload/server.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/object.hpp>
+#include <stdplus/zstring_view.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace phosphor
+{
+namespace network
+{
+
+class Manager;
+
+using ReloadDebugIntf =
+    sdbusplus::xyz::openbmc_project::Network::Debug::server::Reload;
+
+using ReloadDebugObj = sdbusplus::server::object_t<ReloadDebugIntf>;
+
+/** @class ReloadDebug
+ *  @brief Exposes how configuration changes were batched into reloads.
+ */
+class ReloadDebug : public ReloadDebugObj
+{
+  public:
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] objPath - Path to attach at.
+     *  @param[in] policy - The policy scheduling the reloads.
+     *  @param[in] manager - The manager running the reloads.
+     */
+    ReloadDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+                const ReloadPolicy& policy, const Manager& manager);
+
+    std::map<std::string, uint64_t> getReloadStats() override;
+
+  private:
+    const ReloadPolicy& policy;
+    const Manager& manager;
+};
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,41 @@
+#include "reload_policy.hpp"
+
+#include <algorithm>
+
+namespace phosphor
+{
+namespace network
+{
+
+ReloadPolicy::Clock::time_point
+    ReloadPolicy::schedule(Clock::time_point now) noexcept
+{
+    stats.scheduled++;
+    if (!first)
+    {
+        first = now;
+        deadline = now + cfg.initial;
+    }
+    else
+    {
+        deadline = std::max(deadline, now + cfg.window);
+    }
+    deadline = std::min(deadline, *first + cfg.maxLatency);
+    return deadline;
+}
+
+void ReloadPolicy::executed(Clock::time_point now) noexcept
+{
+    if (!first)
+    {
+        return;
+    }
+    stats.executed++;
+    stats.lastLatency = now - *first;
+    stats.maxLatency = std::max(stats.maxLatency, stats.lastLatency);
+    stats.totalLatency += stats.lastLatency;
+    first.reset();
+}
+
+} // namespace network
+} // namespace phosphor
@@ -0,0 +1,79 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+namespace phosphor
+{
+namespace network
+{
+
+/** @class ReloadPolicy
+ *  @brief Decides when a batch of configuration changes gets applied
+ *
+ *  @details The first change after a quiet period runs after a short delay.
+ *           Any further change before then extends the batch until the
+ *           coalescing window has passed without changes, but a batch never
+ *           waits longer than the latency cap counted from its first change.
+ */
+class ReloadPolicy
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config
+    {
+        /** @brief The delay before running an isolated change */
+        std::chrono::milliseconds initial;
+        /** @brief The quiet time required after each change of a burst */
+        std::chrono::milliseconds window;
+        /** @brief The longest any change may wait for its batch to run */
+        std::chrono::milliseconds maxLatency;
+    };
+
+    /** @brief Counters describing how changes were batched */
+    struct Stats
+    {
+        size_t scheduled = 0;
+        size_t executed = 0;
+        /** @brief Time from the first change of a batch until it ran */
+        Clock::duration lastLatency = {};
+        Clock::duration maxLatency = {};
+        Clock::duration totalLatency = {};
+    };
+
+    explicit ReloadPolicy(const Config& cfg) noexcept : cfg(cfg) {}
+
+    /** @brief Records a change
+     *
+     *  @param[in] now - The time of the change
+     *  @return When the batch holding the change should run
+     */
+    Clock::time_point schedule(Clock::time_point now) noexcept;
+
+    /** @brief Records that the pending batch ran
+     *
+     *  @param[in] now - The time the batch ran
+     */
+    void executed(Clock::time_point now) noexcept;
+
+    /** @brief Whether changes are waiting for their batch to run */
+    inline bool pending() const noexcept
+    {
+        return first.has_value();
+    }
+
+    inline const Stats& getStats() const noexcept
+    {
+        return stats;
+    }
+
+  private:
+    Config cfg;
+    std::optional<Clock::time_point> first;
+    Clock::time_point deadline;
+    Stats stats;
+};
+
+} // namespace network
+} // namespace phosphor
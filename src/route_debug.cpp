@@ -0,0 +1,82 @@
+#include "route_debug.hpp"
+
+#include "network_manager.hpp"
+
+#include <phosphor-logging/elog-errors.hpp>
+#include <phosphor-logging/lg2.hpp>
+#include <stdplus/net/addr/subnet.hpp>
+#include <xyz/openbmc_project/Common/error.hpp>
+
+namespace phosphor
+{
+namespace network
+{
+
+using namespace phosphor::logging;
+using namespace sdbusplus::xyz::openbmc_project::Common::Error;
+using Argument = xyz::openbmc_project::Common::InvalidArgument;
+
+RouteDebug::RouteDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+                       const RouteTable& routes, const Manager& manager) :
+    RouteDebugObj(bus, objPath.c_str(),
+                  RouteDebugObj::action::emit_interface_added),
+    routes(routes), manager(manager)
+{}
+
+RouteDebug::Route RouteDebug::toRoute(const RouteInfo& info) const
+{
+    std::vector<std::tuple<std::string, std::string, uint16_t>> nhs;
+    for (const auto& nh : info.nextHops)
+    {
+        std::string name;
+        if (auto intf = manager.intfs.intf(nh.ifidx); intf != nullptr)
+        {
+            name = intf->interfaceName();
+        }
+        nhs.emplace_back(std::move(name),
+                         nh.gateway ? stdplus::toStr(*nh.gateway) : "",
+                         nh.weight);
+    }
+    return {stdplus::toStr(info.dst), info.table, info.priority, info.type,
+            std::move(nhs)};
+}
+
+RouteDebug::Route RouteDebug::lookup(std::string destination)
+{
+    stdplus::InAnyAddr addr;
+    try
+    {
+        addr = stdplus::fromStr<stdplus::InAnyAddr>(destination);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Invalid IP {NET_IP}: {ERROR}", "NET_IP", destination,
+                   "ERROR", e);
+        elog<InvalidArgument>(Argument::ARGUMENT_NAME("Destination"),
+                              Argument::ARGUMENT_VALUE(destination.c_str()));
+    }
+    auto route = routes.lookup(addr);
+    if (route == nullptr)
+    {
+        using ResourceErr =
+            phosphor::logging::xyz::openbmc_project::Common::ResourceNotFound;
+        elog<ResourceNotFound>(ResourceErr::RESOURCE(destination.c_str()));
+    }
+    return toRoute(*route);
+}
+
+std::vector<RouteDebug::Route> RouteDebug::list(uint32_t table)
+{
+    std::vector<Route> ret;
+    ret.reserve(table == 0 ? routes.size() : 0);
+    routes.forEach([&](const RouteInfo& info) {
+        if (table == 0 || info.table == table)
+        {
+            ret.push_back(toRoute(info));
+        }
+    });
+    return ret;
+}
+
+} // namespace network
+} // namespace phosphor
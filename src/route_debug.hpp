@@ -0,0 +1,57 @@
+#pragma once
+#include "route_table.hpp"
+#include "xyz/openbmc_project/Network/Debug/Routes/server.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/object.hpp>
+#include <stdplus/zstring_view.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor
+{
+namespace network
+{
+
+class Manager;
+
+using RouteDebugIntf =
+    sdbusplus::xyz::openbmc_project::Network::Debug::server::Routes;
+
+using RouteDebugObj = sdbusplus::server::object_t<RouteDebugIntf>;
+
+/** @class RouteDebug
+ *  @brief Answers route lookups on D-Bus from the mirrored routing tables.
+ */
+class RouteDebug : public RouteDebugObj
+{
+  public:
+    using Route =
+        std::tuple<std::string, uint32_t, uint32_t, uint8_t,
+                   std::vector<std::tuple<std::string, std::string, uint16_t>>>;
+
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] objPath - Path to attach at.
+     *  @param[in] routes - The mirrored routes.
+     *  @param[in] manager - Resolves interface names.
+     */
+    RouteDebug(sdbusplus::bus_t& bus, stdplus::zstring_view objPath,
+               const RouteTable& routes, const Manager& manager);
+
+    Route lookup(std::string destination) override;
+
+    std::vector<Route> list(uint32_t table) override;
+
+  private:
+    const RouteTable& routes;
+    const Manager& manager;
+
+    Route toRoute(const RouteInfo& info) const;
+};
+
+} // namespace network
+} // namespace phosphor
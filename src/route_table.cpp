@@ -0,0 +1,370 @@
+#include "route_table.hpp"
+
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <variant>
+
+namespace phosphor::network
+{
+
+using Key = RouteTable::Key;
+
+static int familyOf(const stdplus::InAnyAddr& addr) noexcept
+{
+    return std::holds_alternative<stdplus::In4Addr>(addr) ? AF_INET
+                                                          : AF_INET6;
+}
+
+static uint8_t maxLen(int family) noexcept
+{
+    return family == AF_INET ? 32 : 128;
+}
+
+/** @brief Converts an address into a key with bits past len cleared */
+static Key toKey(const stdplus::InAnyAddr& addr, uint8_t len) noexcept
+{
+    Key ret = {};
+    std::visit(
+        [&](const auto& a) {
+            static_assert(sizeof(a) <= sizeof(ret));
+            std::memcpy(ret.data(), &a, sizeof(a));
+        },
+        addr);
+    for (size_t i = len / 8; i < ret.size(); ++i)
+    {
+        ret[i] &= i == len / 8 ? static_cast<uint8_t>(0xff00 >> (len % 8))
+                               : 0;
+    }
+    return ret;
+}
+
+static bool bitAt(const Key& key, uint8_t i) noexcept
+{
+    return (key[i / 8] >> (7 - i % 8)) & 1;
+}
+
+/** @brief The number of leading bits two keys share, at most max */
+static uint8_t commonLen(const Key& a, const Key& b, uint8_t max) noexcept
+{
+    for (unsigned i = 0; i < max; i += 8)
+    {
+        if (uint8_t diff = a[i / 8] ^ b[i / 8]; diff != 0)
+        {
+            return std::min<unsigned>(max, i + std::countl_zero(diff));
+        }
+    }
+    return max;
+}
+
+/** @brief Whether two routes on the same prefix are the same kernel route */
+static bool sameRoute(const RouteInfo& a, const RouteInfo& b) noexcept
+{
+    return a.tos == b.tos && a.priority == b.priority;
+}
+
+uint32_t RouteTable::Trie::alloc(const Key& key, uint8_t len)
+{
+    if (!freeNodes.empty())
+    {
+        auto idx = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[idx] = Node{key, len};
+        return idx;
+    }
+    nodes.push_back(Node{key, len});
+    return nodes.size() - 1;
+}
+
+void RouteTable::Trie::release(uint32_t idx)
+{
+    nodes[idx].routes = {};
+    freeNodes.push_back(idx);
+}
+
+std::vector<RouteInfo>& RouteTable::Trie::insert(const Key& key, uint8_t len)
+{
+    // Links are kept as (parent, side) since allocating may move the nodes
+    uint32_t parent = npos;
+    bool side = false;
+    auto link = [&]() -> uint32_t& {
+        return parent == npos ? root : nodes[parent].child[side];
+    };
+    while (true)
+    {
+        auto idx = link();
+        if (idx == npos)
+        {
+            auto leaf = alloc(key, len);
+            link() = leaf;
+            return nodes[leaf].routes;
+        }
+        auto nlen = nodes[idx].len;
+        auto common = commonLen(nodes[idx].key, key, std::min(nlen, len));
+        if (common == nlen && common == len)
+        {
+            return nodes[idx].routes;
+        }
+        if (common == nlen)
+        {
+            parent = idx;
+            side = bitAt(key, nlen);
+            continue;
+        }
+        auto oldSide = bitAt(nodes[idx].key, common);
+        if (common == len)
+        {
+            // The new prefix covers the existing node
+            auto node = alloc(key, len);
+            nodes[node].child[oldSide] = idx;
+            link() = node;
+            return nodes[node].routes;
+        }
+        // The prefixes diverge below both, join them under a bare node
+        auto branch = alloc(key, common);
+        auto leaf = alloc(key, len);
+        nodes[branch].child[oldSide] = idx;
+        nodes[branch].child[!oldSide] = leaf;
+        link() = branch;
+        return nodes[leaf].routes;
+    }
+}
+
+std::vector<RouteInfo>* RouteTable::Trie::find(const Key& key, uint8_t len)
+{
+    auto idx = root;
+    while (idx != npos)
+    {
+        auto& node = nodes[idx];
+        if (node.len > len || commonLen(node.key, key, node.len) < node.len)
+        {
+            return nullptr;
+        }
+        if (node.len == len)
+        {
+            return &node.routes;
+        }
+        idx = node.child[bitAt(key, node.len)];
+    }
+    return nullptr;
+}
+
+const std::vector<RouteInfo>* RouteTable::Trie::longest(const Key& key,
+                                                        uint8_t maxLen) const
+{
+    const std::vector<RouteInfo>* ret = nullptr;
+    auto idx = root;
+    while (idx != npos)
+    {
+        const auto& node = nodes[idx];
+        if (commonLen(node.key, key, node.len) < node.len)
+        {
+            break;
+        }
+        if (!node.routes.empty())
+        {
+            ret = &node.routes;
+        }
+        if (node.len == maxLen)
+        {
+            break;
+        }
+        idx = node.child[bitAt(key, node.len)];
+    }
+    return ret;
+}
+
+void RouteTable::Trie::erase(const Key& key, uint8_t len)
+{
+    // Erasing never allocates, so references to links stay valid
+    std::vector<uint32_t*> path;
+    uint32_t* link = &root;
+    while (*link != npos && nodes[*link].len < len)
+    {
+        path.push_back(link);
+        link = &nodes[*link].child[bitAt(key, nodes[*link].len)];
+    }
+    if (*link == npos || nodes[*link].len != len ||
+        commonLen(nodes[*link].key, key, len) != len)
+    {
+        return;
+    }
+    nodes[*link].routes.clear();
+
+    // Drop nodes left without routes and with fewer than two children,
+    // which may leave the parent as a bare node with a single child
+    while (true)
+    {
+        auto idx = *link;
+        auto& node = nodes[idx];
+        if (!node.routes.empty())
+        {
+            return;
+        }
+        bool left = node.child[0] != npos;
+        bool right = node.child[1] != npos;
+        if (left && right)
+        {
+            return;
+        }
+        *link = left ? node.child[0] : node.child[1];
+        release(idx);
+        if (*link != npos || path.empty())
+        {
+            return;
+        }
+        link = path.back();
+        path.pop_back();
+    }
+}
+
+void RouteTable::Trie::walk(
+    uint32_t idx, stdplus::function_view<void(const RouteInfo&)> cb) const
+{
+    if (idx == npos)
+    {
+        return;
+    }
+    for (const auto& route : nodes[idx].routes)
+    {
+        cb(route);
+    }
+    walk(nodes[idx].child[0], cb);
+    walk(nodes[idx].child[1], cb);
+}
+
+void RouteTable::add(RouteInfo&& route, bool append)
+{
+    auto addr = route.dst.getAddr();
+    auto len = route.dst.getPfx();
+    auto& routes = tries[{route.table, familyOf(addr)}].insert(
+        toKey(addr, len), len);
+
+    auto it = std::find_if(routes.begin(), routes.end(), [&](const auto& r) {
+        return sameRoute(r, route);
+    });
+    if (it == routes.end())
+    {
+        count++;
+        // Lower priorities are preferred, keep them first for lookups
+        it = std::upper_bound(routes.begin(), routes.end(), route,
+                              [](const auto& a, const auto& b) {
+                                  return a.priority < b.priority;
+                              });
+        routes.insert(it, std::move(route));
+        return;
+    }
+    if (append)
+    {
+        for (auto& nh : route.nextHops)
+        {
+            if (std::find(it->nextHops.begin(), it->nextHops.end(), nh) ==
+                it->nextHops.end())
+            {
+                it->nextHops.push_back(std::move(nh));
+            }
+        }
+        return;
+    }
+    *it = std::move(route);
+}
+
+bool RouteTable::remove(const RouteInfo& route)
+{
+    auto addr = route.dst.getAddr();
+    auto len = route.dst.getPfx();
+    auto trie = tries.find({route.table, familyOf(addr)});
+    if (trie == tries.end())
+    {
+        return false;
+    }
+    auto key = toKey(addr, len);
+    auto routes = trie->second.find(key, len);
+    if (routes == nullptr)
+    {
+        return false;
+    }
+    auto it = std::find_if(routes->begin(), routes->end(), [&](const auto& r) {
+        return sameRoute(r, route);
+    });
+    if (it == routes->end())
+    {
+        return false;
+    }
+
+    // Deleting one multipath sibling only reports that next hop
+    auto& nhs = it->nextHops;
+    auto listed = [&](const NextHop& nh) {
+        return std::find(route.nextHops.begin(), route.nextHops.end(), nh) !=
+               route.nextHops.end();
+    };
+    if (!route.nextHops.empty() &&
+        std::any_of(nhs.begin(), nhs.end(), std::not_fn(listed)))
+    {
+        std::erase_if(nhs, listed);
+        return true;
+    }
+
+    routes->erase(it);
+    count--;
+    if (routes->empty())
+    {
+        trie->second.erase(key, len);
+    }
+    return true;
+}
+
+const RouteInfo* RouteTable::lookup(stdplus::InAnyAddr addr,
+                                    uint32_t table) const
+{
+    auto family = familyOf(addr);
+    auto trie = tries.find({table, family});
+    if (trie == tries.end())
+    {
+        return nullptr;
+    }
+    auto len = maxLen(family);
+    auto routes = trie->second.longest(toKey(addr, len), len);
+    if (routes == nullptr)
+    {
+        return nullptr;
+    }
+    // Routes only matching a specific tos aren't picked for plain traffic
+    auto it = std::find_if(routes->begin(), routes->end(),
+                           [](const auto& r) { return r.tos == 0; });
+    return it == routes->end() ? nullptr : &*it;
+}
+
+const RouteInfo* RouteTable::lookup(stdplus::InAnyAddr addr) const
+{
+    for (uint32_t table : {RT_TABLE_LOCAL, RT_TABLE_MAIN, RT_TABLE_DEFAULT})
+    {
+        if (auto ret = lookup(addr, table); ret != nullptr)
+        {
+            return ret;
+        }
+    }
+    return nullptr;
+}
+
+void RouteTable::forEach(
+    stdplus::function_view<void(const RouteInfo&)> cb) const
+{
+    for (const auto& [_, trie] : tries)
+    {
+        trie.walk(trie.root, cb);
+    }
+}
+
+void RouteTable::clear() noexcept
+{
+    tries.clear();
+    count = 0;
+}
+
+} // namespace phosphor::network
@@ -0,0 +1,106 @@
+#pragma once
+#include "types.hpp"
+
+#include <stdplus/function_view.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace phosphor::network
+{
+
+/** @class RouteTable
+ *  @brief A mirror of the kernel routing tables indexed for longest prefix
+ *         match lookups
+ *
+ *  @details Every (table, family) pair is a path compressed binary trie
+ *           whose nodes live in a single vector and refer to each other by
+ *           index. A node only exists for a route prefix or where two
+ *           prefixes diverge, so the trie holds at most two nodes per
+ *           prefix. Routes sharing a prefix are kept on the same node and
+ *           identified by their tos and priority like the kernel does.
+ */
+class RouteTable
+{
+  public:
+    /** @brief Adds a route or replaces the one with the same identity
+     *
+     *  @param[in] route  - The route to add
+     *  @param[in] append - Add the next hops to an existing route instead,
+     *                      as the kernel reports new IPv6 multipath siblings
+     */
+    void add(RouteInfo&& route, bool append = false);
+
+    /** @brief Removes a route, or only the listed next hops if the route
+     *         has others left
+     *
+     *  @return False if no such route was known
+     */
+    bool remove(const RouteInfo& route);
+
+    /** @brief Finds the route taken by traffic to an address in one table
+     *
+     *  @return nullptr if no route matches
+     */
+    const RouteInfo* lookup(stdplus::InAnyAddr addr, uint32_t table) const;
+
+    /** @brief Finds the route taken by traffic to an address following the
+     *         default rules, which try the local, main and default tables
+     *
+     *  @return nullptr if no route matches
+     */
+    const RouteInfo* lookup(stdplus::InAnyAddr addr) const;
+
+    /** @brief Calls back with every route, ordered by table, family and
+     *         prefix
+     */
+    void forEach(stdplus::function_view<void(const RouteInfo&)> cb) const;
+
+    inline size_t size() const noexcept
+    {
+        return count;
+    }
+
+    void clear() noexcept;
+
+    /** @brief Bit aligned address, IPv4 only uses the first 4 bytes */
+    using Key = std::array<uint8_t, 16>;
+
+  private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct Node
+    {
+        Key key;
+        uint8_t len;
+        std::array<uint32_t, 2> child = {npos, npos};
+        /** @brief Empty for nodes which only join two subtrees */
+        std::vector<RouteInfo> routes = {};
+    };
+
+    struct Trie
+    {
+        std::vector<Node> nodes;
+        std::vector<uint32_t> freeNodes;
+        uint32_t root = npos;
+
+        uint32_t alloc(const Key& key, uint8_t len);
+        void release(uint32_t idx);
+        std::vector<RouteInfo>& insert(const Key& key, uint8_t len);
+        std::vector<RouteInfo>* find(const Key& key, uint8_t len);
+        const std::vector<RouteInfo>* longest(const Key& key,
+                                              uint8_t maxLen) const;
+        void erase(const Key& key, uint8_t len);
+        void walk(uint32_t idx,
+                  stdplus::function_view<void(const RouteInfo&)> cb) const;
+    };
+
+    /** @brief Tries keyed by table and address family */
+    std::map<std::pair<uint32_t, int>, Trie> tries;
+    size_t count = 0;
+};
+
+} // namespace phosphor::network
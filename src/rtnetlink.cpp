@@ -3,8 +3,18 @@
 #include "netlink.hpp"
 #include "util.hpp"
 
+#include <arpa/inet.h>
+#include <linux/neighbour.h>
 #include <linux/rtnetlink.h>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
 namespace phosphor::network::netlink
 {
 
@@ -16,101 +26,80 @@ static void parseVlanInfo(InterfaceInfo& info, std::string_view msg)
     {
         throw std::runtime_error("Missing VLAN data");
     }
-    while (!msg.empty())
+    RtAttrs<IFLA_VLAN_MAX> attrs(msg);
+    if (auto id = attrs.get<uint16_t>(IFLA_VLAN_ID))
     {
-        auto [hdr, data] = netlink::extractRtAttr(msg);
-        switch (hdr.rta_type)
-        {
-            case IFLA_VLAN_ID:
-                info.vlan_id.emplace(stdplus::raw::copyFrom<uint16_t>(data));
-                break;
-        }
+        info.vlan_id.emplace(*id);
     }
 }
 
 static void parseLinkInfo(InterfaceInfo& info, std::string_view msg)
 {
-    std::string_view submsg;
-    while (!msg.empty())
+    RtAttrs<IFLA_INFO_MAX> attrs(msg);
+    if (auto kind = attrs[IFLA_INFO_KIND]; kind.data() != nullptr)
     {
-        auto [hdr, data] = netlink::extractRtAttr(msg);
-        switch (hdr.rta_type)
-        {
-            case IFLA_INFO_KIND:
-                data.remove_suffix(1);
-                info.kind.emplace(data);
-                break;
-            case IFLA_INFO_DATA:
-                submsg = data;
-                break;
-        }
+        kind.remove_suffix(1);
+        info.kind.emplace(kind);
     }
     if (info.kind == "vlan"sv)
     {
-        parseVlanInfo(info, submsg);
+        parseVlanInfo(info, attrs[IFLA_INFO_DATA]);
     }
 }
 
 InterfaceInfo intfFromRtm(std::string_view msg)
 {
-    const auto& ifinfo = netlink::extractRtData<ifinfomsg>(msg);
+    auto [ifinfo, attrs] = parseRtm<ifinfomsg>(msg);
     InterfaceInfo ret;
     ret.type = ifinfo.ifi_type;
     ret.idx = ifinfo.ifi_index;
     ret.flags = ifinfo.ifi_flags;
-    while (!msg.empty())
+    if (auto name = attrs[IFLA_IFNAME]; name.data() != nullptr)
     {
-        auto [hdr, data] = netlink::extractRtAttr(msg);
-        switch (hdr.rta_type)
-        {
-            case IFLA_IFNAME:
-                ret.name.emplace(data.begin(), data.end() - 1);
-                break;
-            case IFLA_ADDRESS:
-                if (data.size() == sizeof(stdplus::EtherAddr))
-                {
-                    ret.mac.emplace(
-                        stdplus::raw::copyFrom<stdplus::EtherAddr>(data));
-                }
-                break;
-            case IFLA_MTU:
-                ret.mtu.emplace(stdplus::raw::copyFrom<unsigned>(data));
-                break;
-            case IFLA_LINK:
-                ret.parent_idx.emplace(stdplus::raw::copyFrom<unsigned>(data));
-                break;
-            case IFLA_LINKINFO:
-                parseLinkInfo(ret, data);
-                break;
-        }
+        ret.name.emplace(name.begin(), name.end() - 1);
+    }
+    if (auto mac = attrs[IFLA_ADDRESS];
+        mac.size() == sizeof(stdplus::EtherAddr))
+    {
+        ret.mac.emplace(stdplus::raw::copyFrom<stdplus::EtherAddr>(mac));
+    }
+    ret.mtu = attrs.get<unsigned>(IFLA_MTU);
+    ret.parent_idx = attrs.get<unsigned>(IFLA_LINK);
+    if (attrs.contains(IFLA_LINKINFO))
+    {
+        parseLinkInfo(ret, attrs[IFLA_LINKINFO]);
     }
     return ret;
 }
 
-template <typename Addr>
-static std::optional<std::tuple<unsigned, stdplus::InAnyAddr>> parse(
+std::optional<std::tuple<unsigned, rtnl_link_stats64>> statsFromRtm(
     std::string_view msg)
 {
-    std::optional<unsigned> ifIdx;
-    std::optional<stdplus::InAnyAddr> gw;
-    while (!msg.empty())
+    auto [ifinfo, attrs] = parseRtm<ifinfomsg>(msg);
+    auto stats = attrs[IFLA_STATS64];
+    if (stats.data() == nullptr)
     {
-        auto [hdr, data] = extractRtAttr(msg);
-        switch (hdr.rta_type)
-        {
-            case RTA_OIF:
-                ifIdx.emplace(stdplus::raw::copyFromStrict<int>(data));
-                break;
-            case RTA_GATEWAY:
-                gw.emplace(stdplus::raw::copyFromStrict<Addr>(data));
-                break;
-        }
+        return std::nullopt;
     }
-    if (ifIdx && gw)
+    // The struct grows with new kernels, copy whatever both sides know
+    rtnl_link_stats64 ret = {};
+    std::memcpy(&ret, stats.data(), std::min(stats.size(), sizeof(ret)));
+    return std::make_tuple(static_cast<unsigned>(ifinfo.ifi_index), ret);
+}
+
+template <typename Addr>
+static std::optional<std::tuple<unsigned, stdplus::InAnyAddr>> parse(
+    const RtmAttrs<rtmsg>& attrs)
+{
+    if (!attrs.contains(RTA_OIF) || !attrs.contains(RTA_GATEWAY))
     {
-        return std::make_tuple(*ifIdx, *gw);
+        return std::nullopt;
     }
-    return std::nullopt;
+    return std::make_tuple(
+        static_cast<unsigned>(
+            stdplus::raw::copyFromStrict<int>(attrs[RTA_OIF])),
+        stdplus::InAnyAddr(
+            stdplus::raw::copyFromStrict<Addr>(attrs[RTA_GATEWAY])));
 }
 
 std::optional<std::tuple<unsigned, stdplus::InAnyAddr>> gatewayFromRtm(
@@ -124,61 +113,256 @@ std::optional<std::tuple<unsigned, stdplus::InAnyAddr>> gatewayFromRtm(
     switch (rtm.rtm_family)
     {
         case AF_INET:
-            return parse<stdplus::In4Addr>(msg);
+            return parse<stdplus::In4Addr>(RtmAttrs<rtmsg>(msg));
         case AF_INET6:
-            return parse<stdplus::In6Addr>(msg);
+            return parse<stdplus::In6Addr>(RtmAttrs<rtmsg>(msg));
     }
     return std::nullopt;
 }
 
 AddressInfo addrFromRtm(std::string_view msg)
 {
-    const auto& ifa = extractRtData<ifaddrmsg>(msg);
+    auto [ifa, attrs] = parseRtm<ifaddrmsg>(msg);
 
     uint32_t flags = ifa.ifa_flags;
-    std::optional<stdplus::InAnyAddr> addr;
-    while (!msg.empty())
+    if (attrs.contains(IFA_FLAGS))
     {
-        auto [hdr, data] = extractRtAttr(msg);
-        if (hdr.rta_type == IFA_ADDRESS)
-        {
-            addr.emplace(addrFromBuf(ifa.ifa_family, data));
-        }
-        else if (hdr.rta_type == IFA_FLAGS)
-        {
-            flags = stdplus::raw::copyFromStrict<uint32_t>(data);
-        }
+        flags = stdplus::raw::copyFromStrict<uint32_t>(attrs[IFA_FLAGS]);
     }
-    if (!addr)
+    if (!attrs.contains(IFA_ADDRESS))
     {
         throw std::runtime_error("Missing address");
     }
-    return AddressInfo{.ifidx = ifa.ifa_index,
-                       .ifaddr = stdplus::SubnetAny{*addr, ifa.ifa_prefixlen},
-                       .scope = ifa.ifa_scope,
-                       .flags = flags};
+    return AddressInfo{
+        .ifidx = ifa.ifa_index,
+        .ifaddr = stdplus::SubnetAny{addrFromBuf(ifa.ifa_family,
+                                                 attrs[IFA_ADDRESS]),
+                                     ifa.ifa_prefixlen},
+        .scope = ifa.ifa_scope,
+        .flags = flags};
 }
 
 NeighborInfo neighFromRtm(std::string_view msg)
 {
-    const auto& ndm = netlink::extractRtData<ndmsg>(msg);
+    auto [ndm, attrs] = parseRtm<ndmsg>(msg);
 
     NeighborInfo ret;
     ret.ifidx = ndm.ndm_ifindex;
     ret.state = ndm.ndm_state;
-    while (!msg.empty())
+    ret.mac = attrs.get<stdplus::EtherAddr>(NDA_LLADDR);
+    if (attrs.contains(NDA_DST))
     {
-        auto [hdr, data] = netlink::extractRtAttr(msg);
-        if (hdr.rta_type == NDA_LLADDR)
-        {
-            ret.mac = stdplus::raw::copyFrom<stdplus::EtherAddr>(data);
-        }
-        else if (hdr.rta_type == NDA_DST)
+        ret.addr = addrFromBuf(ndm.ndm_family, attrs[NDA_DST]);
+    }
+    return ret;
+}
+
+static std::optional<stdplus::InAnyAddr> gatewayFromAttrs(
+    int family, std::string_view gw, std::string_view via)
+{
+    if (gw.data() != nullptr)
+    {
+        return addrFromBuf(family, gw);
+    }
+    if (via.size() > sizeof(rtvia::rtvia_family))
+    {
+        auto viaFamily = stdplus::raw::copyFrom<rtvia>(via).rtvia_family;
+        via.remove_prefix(sizeof(rtvia::rtvia_family));
+        return addrFromBuf(viaFamily, via);
+    }
+    return std::nullopt;
+}
+
+static std::vector<NextHop> parseMultipath(int family, std::string_view msg)
+{
+    std::vector<NextHop> ret;
+    while (msg.size() >= sizeof(rtnexthop))
+    {
+        auto rtnh = stdplus::raw::copyFrom<rtnexthop>(msg);
+        if (rtnh.rtnh_len < sizeof(rtnh) || rtnh.rtnh_len > msg.size())
         {
-            ret.addr = addrFromBuf(ndm.ndm_family, data);
+            throw std::runtime_error("Bad rtnexthop length");
         }
+        RtAttrs<RTA_MAX> attrs(
+            msg.substr(RTNH_LENGTH(0), rtnh.rtnh_len - RTNH_LENGTH(0)));
+        ret.push_back(NextHop{
+            .ifidx = static_cast<unsigned>(rtnh.rtnh_ifindex),
+            .gateway = gatewayFromAttrs(family, attrs[RTA_GATEWAY],
+                                        attrs[RTA_VIA]),
+            .weight = static_cast<uint16_t>(rtnh.rtnh_hops + 1),
+        });
+        msg.remove_prefix(std::min<size_t>(RTNH_ALIGN(rtnh.rtnh_len),
+                                           msg.size()));
     }
     return ret;
 }
 
+RouteInfo routeFromRtm(std::string_view msg)
+{
+    auto [rtm, attrs] = parseRtm<rtmsg>(msg);
+
+    stdplus::InAnyAddr dst;
+    switch (rtm.rtm_family)
+    {
+        case AF_INET:
+            dst = stdplus::In4Addr{};
+            break;
+        case AF_INET6:
+            dst = stdplus::In6Addr{};
+            break;
+        default:
+            throw std::runtime_error("Unrecognized route family");
+    }
+    if (attrs.contains(RTA_DST))
+    {
+        dst = addrFromBuf(rtm.rtm_family, attrs[RTA_DST]);
+    }
+    RouteInfo ret{
+        .table = attrs.get<uint32_t>(RTA_TABLE).value_or(rtm.rtm_table),
+        .dst = stdplus::SubnetAny{dst, rtm.rtm_dst_len},
+        .tos = rtm.rtm_tos,
+        .priority = attrs.get<uint32_t>(RTA_PRIORITY).value_or(0),
+        .protocol = rtm.rtm_protocol,
+        .scope = rtm.rtm_scope,
+        .type = rtm.rtm_type,
+    };
+    if (attrs.contains(RTA_METRICS))
+    {
+        ret.mtu = RtAttrs<RTAX_MAX>(attrs[RTA_METRICS]).get<uint32_t>(RTAX_MTU);
+    }
+    if (attrs.contains(RTA_MULTIPATH))
+    {
+        ret.nextHops = parseMultipath(rtm.rtm_family, attrs[RTA_MULTIPATH]);
+    }
+    else if (attrs.contains(RTA_OIF) || attrs.contains(RTA_GATEWAY) ||
+             attrs.contains(RTA_VIA))
+    {
+        ret.nextHops.push_back(NextHop{
+            .ifidx = attrs.get<uint32_t>(RTA_OIF).value_or(0),
+            .gateway = gatewayFromAttrs(rtm.rtm_family, attrs[RTA_GATEWAY],
+                                        attrs[RTA_VIA]),
+        });
+    }
+    return ret;
+}
+
+unsigned Event::ifidx() const noexcept
+{
+    return std::visit(
+        [](const auto& i) {
+            if constexpr (std::is_same_v<InterfaceInfo,
+                                         std::decay_t<decltype(i)>>)
+            {
+                return i.idx;
+            }
+            else
+            {
+                return i.ifidx;
+            }
+        },
+        info);
+}
+
+uint16_t Event::type() const noexcept
+{
+    constexpr std::array<std::pair<uint16_t, uint16_t>, 4> types = {{
+        {RTM_NEWLINK, RTM_DELLINK},
+        {RTM_NEWADDR, RTM_DELADDR},
+        {RTM_NEWNEIGH, RTM_DELNEIGH},
+        {RTM_NEWROUTE, RTM_DELROUTE},
+    }};
+    static_assert(types.size() == std::variant_size_v<decltype(info)>);
+    const auto& [newType, delType] = types[info.index()];
+    return add ? newType : delType;
+}
+
+std::optional<Event> eventFromRtm(uint16_t type, std::string_view msg)
+{
+    switch (type)
+    {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            return Event{type == RTM_NEWLINK, intfFromRtm(msg)};
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+            return Event{type == RTM_NEWADDR, addrFromRtm(msg)};
+        case RTM_NEWNEIGH:
+        case RTM_DELNEIGH:
+            return Event{type == RTM_NEWNEIGH, neighFromRtm(msg)};
+        case RTM_NEWROUTE:
+        case RTM_DELROUTE:
+            if (auto gw = gatewayFromRtm(msg))
+            {
+                auto [ifidx, addr] = *gw;
+                return Event{type == RTM_NEWROUTE, DefGwInfo{ifidx, addr}};
+            }
+            break;
+    }
+    return std::nullopt;
+}
+
+std::vector<sock_filter> eventFilter(
+    const std::unordered_set<unsigned>& ignored, bool allRoutes,
+    bool allNeighbors)
+{
+    // Classic BPF loads fields in network byte order while netlink uses host
+    // order, so constants are converted the same way before comparing.
+    // Events carry a single message, so only the first header is checked.
+    constexpr uint32_t typeOff = offsetof(nlmsghdr, nlmsg_type);
+    constexpr uint32_t bodyOff = NLMSG_HDRLEN;
+    static_assert(offsetof(ifaddrmsg, ifa_index) ==
+                  offsetof(ndmsg, ndm_ifindex));
+    constexpr uint32_t idxOff = bodyOff + offsetof(ndmsg, ndm_ifindex);
+    constexpr uint32_t stateOff = bodyOff + offsetof(ndmsg, ndm_state);
+    constexpr uint32_t tableOff = bodyOff + offsetof(rtmsg, rtm_table);
+
+    const auto n = std::min(ignored.size(), maxFilteredIntfs);
+    // Jumps only go forward, so both verdicts sit at the end
+    const uint8_t accept = 12 + n;
+    const uint8_t drop = accept + 1;
+    std::vector<sock_filter> prog;
+    prog.reserve(drop + 1);
+    auto jump = [&](uint16_t code, uint32_t k, uint8_t jt, uint8_t jf) {
+        const uint8_t pc = prog.size() + 1;
+        const uint8_t jtOff = jt == 0 ? 0 : jt - pc;
+        const uint8_t jfOff = jf == 0 ? 0 : jf - pc;
+        prog.push_back(BPF_JUMP(code, k, jtOff, jfOff));
+    };
+    constexpr uint8_t idx = 11;
+    const uint8_t route = allRoutes ? accept : 7;
+    const uint8_t neigh = allNeighbors ? idx : 9;
+
+    prog.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_ABS, typeOff));
+    jump(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_NEWNEIGH), neigh, 0);
+    jump(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_DELNEIGH), idx, 0);
+    jump(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_NEWADDR), idx, 0);
+    jump(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_DELADDR), idx, 0);
+    jump(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_NEWROUTE), route, 0);
+    jump(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_DELROUTE), route, accept);
+
+    // route:
+    prog.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, tableOff));
+    jump(BPF_JMP | BPF_JEQ | BPF_K, RT_TABLE_MAIN, accept, drop);
+
+    // neigh:
+    prog.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_ABS, stateOff));
+    jump(BPF_JMP | BPF_JSET | BPF_K, htons(NUD_PERMANENT), 0, drop);
+
+    // idx:
+    prog.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, idxOff));
+    auto it = ignored.begin();
+    for (size_t i = 0; i < n; ++i, ++it)
+    {
+        jump(BPF_JMP | BPF_JEQ | BPF_K, htonl(*it), drop, 0);
+    }
+
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, 0xffffffff));
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+    if (prog.size() != drop + 1u)
+    {
+        throw std::logic_error("Event filter layout mismatch");
+    }
+    return prog;
+}
+
 } // namespace phosphor::network::netlink
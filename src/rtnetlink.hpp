@@ -1,15 +1,29 @@
 #pragma once
 #include "types.hpp"
 
+#include <linux/filter.h>
+#include <linux/if_link.h>
+
 #include <optional>
 #include <string_view>
 #include <tuple>
+#include <unordered_set>
+#include <variant>
+#include <vector>
 
 namespace phosphor::network::netlink
 {
 
 InterfaceInfo intfFromRtm(std::string_view msg);
 
+/** @brief Decodes the 64 bit counters of a link message
+ *
+ *  @return The ifindex and counters, or nullopt if the message has none.
+ *          Counters the running kernel doesn't report are left zero.
+ */
+std::optional<std::tuple<unsigned, rtnl_link_stats64>> statsFromRtm(
+    std::string_view msg);
+
 std::optional<std::tuple<unsigned, stdplus::InAnyAddr>> gatewayFromRtm(
     std::string_view msg);
 
@@ -17,4 +31,56 @@ AddressInfo addrFromRtm(std::string_view msg);
 
 NeighborInfo neighFromRtm(std::string_view msg);
 
+/** @brief Decodes a route from any table, including all next hops */
+RouteInfo routeFromRtm(std::string_view msg);
+
+/** @brief A default gateway learned from a route event */
+struct DefGwInfo
+{
+    unsigned ifidx;
+    stdplus::InAnyAddr addr;
+
+    constexpr bool operator==(const DefGwInfo& rhs) const noexcept = default;
+};
+
+/** @brief An rtnetlink event decoded into what the manager consumes */
+struct Event
+{
+    bool add;
+    std::variant<InterfaceInfo, AddressInfo, NeighborInfo, DefGwInfo> info;
+
+    /** @brief The interface the event refers to */
+    unsigned ifidx() const noexcept;
+
+    /** @brief The nlmsg_type the event was decoded from */
+    uint16_t type() const noexcept;
+};
+
+/** @brief Decodes an rtnetlink event
+ *
+ *  @param[in] type - The nlmsg_type of the event
+ *  @param[in] msg  - The payload of the event
+ *  @return The event, or nullopt if the manager has no use for it
+ */
+std::optional<Event> eventFromRtm(uint16_t type, std::string_view msg);
+
+/** @brief The most ignored interfaces the event filter matches on, events
+ *         for any beyond that are still dropped by the handlers
+ */
+constexpr size_t maxFilteredIntfs = 128;
+
+/** @brief Builds a classic BPF program for the event socket which drops
+ *         events the manager would discard anyway: non-permanent neighbor
+ *         updates, routes outside the main table, and address or neighbor
+ *         events on ignored interfaces. Link events always pass.
+ *
+ *  @param[in] ignored      - The ifindexes of ignored interfaces
+ *  @param[in] allRoutes    - Pass routes from every table
+ *  @param[in] allNeighbors - Pass neighbors in every state
+ *  @return The program to attach with SO_ATTACH_FILTER
+ */
+std::vector<sock_filter> eventFilter(
+    const std::unordered_set<unsigned>& ignored, bool allRoutes = false,
+    bool allNeighbors = false);
+
 } // namespace phosphor::network::netlink
@@ -1,19 +1,46 @@
+#include "config.h"
+
 #include "rtnetlink_server.hpp"
 
+#include "neighbor_table.hpp"
 #include "netlink.hpp"
 #include "network_manager.hpp"
+#include "route_table.hpp"
 #include "rtnetlink.hpp"
 
+#include <linux/if_addr.h>
+#include <linux/neighbour.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <sys/socket.h>
 
 #include <phosphor-logging/lg2.hpp>
 #include <stdplus/fd/create.hpp>
 #include <stdplus/fd/ops.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cerrno>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
 namespace phosphor::network::netlink
 {
 
+/** @brief Receive buffer size requested for the event socket */
+constexpr int eventSockRcvBuf = 1024 * 1024;
+
+/** @brief Distinct pending events before they are applied mid-drain */
+constexpr size_t maxPendingEvents = 1024;
+
+/** @brief Events the reader thread can queue ahead of the event loop */
+constexpr size_t eventQueueDepth = 4096;
+
 inline void rthandler(std::string_view data, auto&& cb)
 {
     auto ret = gatewayFromRtm(data);
@@ -41,78 +68,591 @@ static unsigned getIfIdx(const nlmsghdr& hdr, std::string_view data)
     throw std::runtime_error("Unknown nlmsg_type");
 }
 
-// 负责处理 Linux 内核通过 Netlink 协议发送的网络事件通知的核心处理函数
-// 该函数是一个静态回调函数，作为内核网络事件的处理器，接收并解析来自 Linux
-// 内核的 RTNETLINK 消息，然后将这些消息转换为 phosphor-networkd
-// 网络管理系统中的相应操作，它是系统感知和响应底层网络变化的关键组件
+/** @brief The dumps needed to learn everything the manager tracks
+ *
+ *  @details Each dump runs on its own socket, since the kernel only runs one
+ *           dump per socket at a time, so they are all prepared concurrently.
+ *           Replies are consumed links first as addresses, routes and
+ *           neighbors are only accepted for interfaces already known.
+ */
+struct Dumps
+{
+    Request links;
+    Request addrs;
+    Request routes;
+    Request neighs;
+
+    inline void receive(ReceiveCallback cb)
+    {
+        links.receive(cb);
+        addrs.receive(cb);
+        routes.receive(cb);
+        neighs.receive(cb);
+    }
+
+    inline bool interrupted() const noexcept
+    {
+        return links.interrupted() || addrs.interrupted() ||
+               routes.interrupted() || neighs.interrupted();
+    }
+};
+
+/** @brief The mirror of every kernel route, null unless enabled */
+static RouteTable* routeTable()
+{
+    static RouteTable table;
+    return ROUTE_CACHE ? &table : nullptr;
+}
+
+/** @brief The mirror of every kernel neighbor, null unless enabled */
+static NeighborTable* neighborTable()
+{
+    static NeighborTable table;
+    return NEIGHBOR_CACHE ? &table : nullptr;
+}
+
+/** @brief Builds the dump requests, asking the kernel to leave out what the
+ *         manager would discard. Kernels without strict checking ignore the
+ *         filters and return everything, which the handlers still cope with.
+ *
+ *  @param[in] ifidx - Restricts the dumps to one interface if non-zero
+ *  @return The links, addresses, routes and neighbors requests in that order
+ */
+static std::array<MsgBuilder, 4> dumpMsgs(unsigned ifidx)
+{
+    // Link stats are never read and make up most of each link message
+    MsgBuilder links;
+    ifinfomsg ifi{};
+    ifi.ifi_index = ifidx;
+    links.begin(RTM_GETLINK, ifidx == 0 ? NLM_F_DUMP : 0, ifi)
+        .attr(IFLA_EXT_MASK, uint32_t{RTEXT_FILTER_SKIP_STATS});
+
+    MsgBuilder addrs;
+    ifaddrmsg ifa{};
+    ifa.ifa_index = ifidx;
+    addrs.begin(RTM_GETADDR, NLM_F_DUMP, ifa);
+
+    // Only default gateways from the main table are tracked, unless every
+    // route is mirrored
+    MsgBuilder routes;
+    rtmsg rtm{};
+    rtm.rtm_table = routeTable() != nullptr ? RT_TABLE_UNSPEC : RT_TABLE_MAIN;
+    routes.begin(RTM_GETROUTE, NLM_F_DUMP, rtm);
+
+    // Neighbor dumps can't be filtered by state, the kernel rejects a
+    // non-zero ndm_state in strict mode
+    MsgBuilder neighs;
+    neighs.begin(RTM_GETNEIGH, NLM_F_DUMP, ndmsg{});
+
+    if (ifidx != 0)
+    {
+        routes.attr(RTA_OIF, uint32_t{ifidx});
+        neighs.attr(NDA_IFINDEX, uint32_t{ifidx});
+    }
+
+    return {std::move(links), std::move(addrs), std::move(routes),
+            std::move(neighs)};
+}
+
+/** @brief Issues the dumps on pooled sockets
+ *
+ *  @param[in] ifidx - Restricts the dumps to one interface if non-zero
+ */
+static Dumps requestDumps(unsigned ifidx = 0)
+{
+    auto [links, addrs, routes, neighs] = dumpMsgs(ifidx);
+    return Dumps{
+        .links = Request(NETLINK_ROUTE, links),
+        .addrs = Request(NETLINK_ROUTE, addrs),
+        .routes = Request(NETLINK_ROUTE, routes),
+        .neighs = Request(NETLINK_ROUTE, neighs),
+    };
+}
+
+static bool redumpIntf(Manager& m, unsigned ifidx);
+
+/** @brief The counters of every message handled by this process */
+static MessageStats& messageStats()
+{
+    static MessageStats stats;
+    return stats;
+}
+
+/** @brief Mirrors a route message into a route table */
+static void trackRoute(RouteTable& table, const nlmsghdr& hdr,
+                       std::string_view data)
+{
+    if (hdr.nlmsg_type != RTM_NEWROUTE && hdr.nlmsg_type != RTM_DELROUTE)
+    {
+        return;
+    }
+    try
+    {
+        // Cloned routes are per destination cache entries
+        if (extractRtData<rtmsg>(data).rtm_flags & RTM_F_CLONED)
+        {
+            return;
+        }
+        auto route = routeFromRtm(data);
+        if (hdr.nlmsg_type == RTM_NEWROUTE)
+        {
+            table.add(std::move(route), hdr.nlmsg_flags & NLM_F_APPEND);
+        }
+        else
+        {
+            table.remove(route);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        messageStats().failed(hdr.nlmsg_type);
+        lg2::error("Failed handling netlink route: {ERROR}", "ERROR", e);
+    }
+}
+
+/** @brief Mirrors a route message if routes are mirrored at all */
+static void trackRoute(const nlmsghdr& hdr, std::string_view data)
+{
+    if (auto table = routeTable(); table != nullptr)
+    {
+        trackRoute(*table, hdr, data);
+    }
+}
+
+/** @brief Mirrors a neighbor event, and forgets the neighbors of removed
+ *         links in case the kernel flushed them without telling us
+ */
+static void trackNeighbor(const Manager& m, const Event& e)
+{
+    auto table = neighborTable();
+    if (table == nullptr || m.intfs.ignored(e.ifidx()))
+    {
+        return;
+    }
+    if (auto info = std::get_if<NeighborInfo>(&e.info); info != nullptr)
+    {
+        if (info->addr)
+        {
+            e.add ? table->update(*info) : table->remove(*info);
+        }
+    }
+    else if (!e.add && std::holds_alternative<InterfaceInfo>(e.info))
+    {
+        table->removeIntf(e.ifidx());
+    }
+}
+
+/** @brief Decodes an event, logging anything malformed
+ *
+ *  @return The event, or nullopt if there is nothing to apply
+ */
+static std::optional<Event> decode(const Manager& m, const nlmsghdr& hdr,
+                                   std::string_view data)
+{
+    try
+    {
+        return eventFromRtm(hdr.nlmsg_type, data);
+    }
+    catch (const std::exception& e)
+    {
+        messageStats().failed(hdr.nlmsg_type);
+        try
+        {
+            if (m.intfs.ignored(getIfIdx(hdr, data)))
+            {
+                // We don't want to log errors for ignored interfaces
+                return std::nullopt;
+            }
+        }
+        catch (...)
+        {}
+        lg2::error("Failed handling netlink event: {ERROR}", "ERROR", e);
+    }
+    return std::nullopt;
+}
+
+// 负责把 Linux 内核通过 Netlink 协议发送的网络事件应用到 Manager
+// 每种事件转发给 Manager 中对应的方法，它是系统感知和响应底层网络变化的
+// 关键组件
+static void apply(Manager& m, const Event& e)
+{
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        trackNeighbor(m, e);
+        std::visit(
+            [&](const auto& info) {
+                using T = std::decay_t<decltype(info)>;
+                if constexpr (std::is_same_v<T, InterfaceInfo>)
+                {
+                    e.add ? m.addInterface(info) : m.removeInterface(info);
+                }
+                else if constexpr (std::is_same_v<T, AddressInfo>)
+                {
+                    e.add ? m.addAddress(info) : m.removeAddress(info);
+                }
+                else if constexpr (std::is_same_v<T, NeighborInfo>)
+                {
+                    e.add ? m.addNeighbor(info) : m.removeNeighbor(info);
+                }
+                else
+                {
+                    e.add ? m.addDefGw(info.ifidx, info.addr)
+                          : m.removeDefGw(info.ifidx, info.addr);
+                }
+            },
+            e.info);
+        messageStats().applied(e.type(),
+                               std::chrono::steady_clock::now() - start);
+    }
+    catch (const std::exception& ex)
+    {
+        messageStats().failed(e.type());
+        try
+        {
+            auto ifidx = e.ifidx();
+            if (m.intfs.ignored(ifidx))
+            {
+                // We don't want to log errors for ignored interfaces
+                return;
+            }
+            if (e.add && !std::holds_alternative<InterfaceInfo>(e.info) &&
+                !m.hasIntf(ifidx) && redumpIntf(m, ifidx))
+            {
+                // The link event was missed, the whole interface was fetched
+                return;
+            }
+        }
+        catch (...)
+        {}
+        lg2::error("Failed handling netlink event: {ERROR}", "ERROR", ex);
+    }
+}
+
+/** @brief Applies a message straight away, used for dump replies */
 static void handler(Manager& m, const nlmsghdr& hdr, std::string_view data)
 {
-    // 事件分发处理
-    // 函数使用 switch 语句根据消息类型 (hdr.nlmsg_type)
-    // intfFromRtm 解析接口信息
-    // rthandler 辅助函数提取网关信息
-    // neighFromRtm 解析邻居信息并转发给Manager相应方法
+    messageStats().received(hdr.nlmsg_type, hdr.nlmsg_len);
+    trackRoute(hdr, data);
+    if (auto e = decode(m, hdr, data))
+    {
+        apply(m, *e);
+    }
+}
+
+/** @brief Learns a single interface and everything on it, used when an
+ *         event refers to an interface that was never announced
+ *
+ *  @return False if a re-dump is already in progress
+ */
+static bool redumpIntf(Manager& m, unsigned ifidx)
+{
+    // Anything failing inside the re-dump must not start another one
+    static bool active = false;
+    if (active)
+    {
+        return false;
+    }
+    active = true;
+    auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
+        handler(m, hdr, data);
+    };
+    try
+    {
+        requestDumps(ifidx).receive(cb);
+    }
+    catch (...)
+    {
+        active = false;
+        throw;
+    }
+    active = false;
+    return true;
+}
+
+/** @brief Records a dumped object into a snapshot of the kernel state,
+ *         keeping only what the manager would track from the same event
+ *
+ *  @param[in] neighs - Also collects neighbors in every state if non-null
+ */
+static void collect(std::unordered_map<unsigned, AllIntfInfo>& state,
+                    NeighborTable* neighs, const nlmsghdr& hdr,
+                    std::string_view data)
+{
     try
     {
         switch (hdr.nlmsg_type)
         {
             case RTM_NEWLINK:
-                m.addInterface(intfFromRtm(data));
-                break;
-            case RTM_DELLINK:
-                m.removeInterface(intfFromRtm(data));
+            {
+                auto intf = intfFromRtm(data);
+                auto idx = intf.idx;
+                state[idx].intf = std::move(intf);
                 break;
+            }
             case RTM_NEWROUTE:
                 rthandler(data, [&](auto ifidx, auto addr) {
-                    m.addDefGw(ifidx, addr);
-                });
-                break;
-            case RTM_DELROUTE:
-                rthandler(data, [&](auto ifidx, auto addr) {
-                    m.removeDefGw(ifidx, addr);
+                    std::visit(
+                        [&](auto addr) {
+                            if constexpr (std::is_same_v<stdplus::In4Addr,
+                                                         decltype(addr)>)
+                            {
+                                state[ifidx].defgw4.emplace(addr);
+                            }
+                            else
+                            {
+                                state[ifidx].defgw6.emplace(addr);
+                            }
+                        },
+                        addr);
                 });
                 break;
             case RTM_NEWADDR:
-                m.addAddress(addrFromRtm(data));
-                break;
-            case RTM_DELADDR:
-                m.removeAddress(addrFromRtm(data));
+            {
+                auto info = addrFromRtm(data);
+                if (!(info.flags & IFA_F_DEPRECATED))
+                {
+                    state[info.ifidx].addrs.insert_or_assign(info.ifaddr,
+                                                             info);
+                }
                 break;
+            }
             case RTM_NEWNEIGH:
-                m.addNeighbor(neighFromRtm(data));
-                break;
-            case RTM_DELNEIGH:
-                m.removeNeighbor(neighFromRtm(data));
+            {
+                auto info = neighFromRtm(data);
+                if (neighs != nullptr && info.addr)
+                {
+                    neighs->update(info);
+                }
+                if ((info.state & NUD_PERMANENT) && info.addr)
+                {
+                    state[info.ifidx].staticNeighs.insert_or_assign(
+                        *info.addr, info);
+                }
                 break;
+            }
         }
     }
     catch (const std::exception& e)
     {
-        try
-        {
-            if (m.ignoredIntf.contains(getIfIdx(hdr, data)))
+        lg2::error("Failed handling netlink dump: {ERROR}", "ERROR", e);
+    }
+}
+
+/** @brief Re-dumps the kernel state after events were lost or a dump was
+ *         interrupted, then hands the manager only the differences
+ */
+static void resync(Manager& m)
+{
+    constexpr unsigned maxAttempts = 3;
+
+    std::unordered_map<unsigned, AllIntfInfo> state;
+    RouteTable routes;
+    NeighborTable neighs;
+    bool interrupted = true;
+    for (unsigned i = 0; i < maxAttempts && interrupted; ++i)
+    {
+        state.clear();
+        routes.clear();
+        neighs = NeighborTable();
+        auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
+            collect(state, neighborTable() != nullptr ? &neighs : nullptr,
+                    hdr, data);
+            if (routeTable() != nullptr)
             {
-                // We don't want to log errors for ignored interfaces
-                return;
+                trackRoute(routes, hdr, data);
             }
+        };
+        auto dumps = requestDumps();
+        dumps.receive(cb);
+        interrupted = dumps.interrupted();
+    }
+    if (interrupted)
+    {
+        lg2::warning("Netlink state kept changing during resync, applying "
+                     "the last dump");
+    }
+
+    // Objects only referenced by addresses or routes were never dumped
+    // as links, so they are gone by now
+    std::erase_if(state, [](const auto& e) { return e.second.intf.idx == 0; });
+
+    if (auto table = routeTable(); table != nullptr)
+    {
+        *table = std::move(routes);
+    }
+    if (auto table = neighborTable(); table != nullptr)
+    {
+        for (auto ifidx : m.intfs.ignoredIntfs())
+        {
+            neighs.removeIntf(ifidx);
         }
-        catch (...)
-        {}
-        lg2::error("Failed handling netlink event: {ERROR}", "ERROR", e);
+        table->assign(std::move(neighs));
+    }
+    auto changes = m.reconcile(state);
+    lg2::info("Resynced netlink state: {CHANGES} changes", "CHANGES", changes);
+}
+
+/** @brief Buffers an event, applying the buffer early once it is full */
+static void coalesce(Manager& m, EventCoalescer& events, Event&& e)
+{
+    events.push(std::move(e));
+    // Bounds the latency of a very long drain, the coalescer compacts itself
+    // so the memory it holds stays proportional to what is pending
+    if (events.pending() >= maxPendingEvents)
+    {
+        events.flush([&](const Event& e) { apply(m, e); });
     }
 }
 
-// 接收内核事件，把ip，等消息传递给handler处理
+// 接收内核事件，把ip，等消息交给合并器，读完后一次性应用到 Manager
 // 该函数是一个事件处理回调，当 Netlink 套接字上有数据可读时被调用
-// 它负责从套接字接收数据，解析 Netlink 消息，并将这些消息传递给
-// 主处理函数 handler 进行处理
-static void eventHandler(Manager& m, sdeventplus::source::IO&, int fd, uint32_t)
+// 同一对象在一批事件中的多次变化只会应用最后的状态，从而每个接口只发出
+// 一批 D-Bus 信号
+static void eventHandler(Manager& m, BatchReceiver& rx, EventCoalescer& events,
+                         sdeventplus::source::IO&, int fd, uint32_t)
+{
+    auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
+        messageStats().received(hdr.nlmsg_type, hdr.nlmsg_len);
+        trackRoute(hdr, data);
+        if (auto e = decode(m, hdr, data))
+        {
+            coalesce(m, events, *std::move(e));
+        }
+    };
+    rx.receive(fd, cb);
+    events.flush([&](const Event& e) { apply(m, e); });
+    if (rx.takeOverrun())
+    {
+        lg2::error("Netlink event socket overran, resyncing");
+        resync(m);
+    }
+}
+
+// 启动时在已订阅的事件套接字上依次执行各个 dump，应答与事件按内核入队的
+// 顺序交给合并器，每个对象只应用一次
+// The replies are told apart from the events by their sequence number, and
+// since both arrive in kernel order nothing that changed during the dump is
+// lost or applied out of order.
+//
+// @return Whether the dump needs to be repeated by a resync
+static bool initialDump(Manager& m, int fd, EventCoalescer& events)
 {
-    auto cb = [&](auto&&... args) {
-        return handler(m, std::forward<decltype(args)>(args)...);
+    auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
+        messageStats().received(hdr.nlmsg_type, hdr.nlmsg_len);
+        trackRoute(hdr, data);
+        if (auto e = decode(m, hdr, data))
+        {
+            coalesce(m, events, *std::move(e));
+        }
     };
-    while (receive(fd, cb) > 0)
-        ;
+    // The kernel runs a single dump per socket at a time
+    InlineDump total;
+    for (auto& msg : dumpMsgs(0))
+    {
+        auto ret = dumpInline(fd, msg, cb);
+        total.replies += ret.replies;
+        total.events += ret.events;
+        total.interrupted |= ret.interrupted;
+        total.overrun |= ret.overrun;
+    }
+    events.flush([&](const Event& e) { apply(m, e); });
+    lg2::info("Initial netlink dump: {REPLIES} replies, {EVENTS} events",
+              "REPLIES", total.replies, "EVENTS", total.events);
+    return total.interrupted || total.overrun;
+}
+
+/** @brief Applies the events decoded by the reader thread */
+static void readerHandler(Manager& m, EventReader& reader,
+                          EventCoalescer& events)
+{
+    reader.drain([&](EventReader::Item&& item) {
+        if (auto* e = std::get_if<Event>(&item))
+        {
+            coalesce(m, events, std::move(*e));
+            return;
+        }
+        // Decoded again here as only this thread may look at the manager
+        auto& u = std::get<EventReader::Undecoded>(item);
+        trackRoute(u.hdr, u.data);
+        if (auto e = decode(m, u.hdr, u.data))
+        {
+            coalesce(m, events, *std::move(e));
+        }
+    });
+    events.flush([&](const Event& e) { apply(m, e); });
+    if (reader.takeResync())
+    {
+        lg2::error("Netlink events were lost by the reader, resyncing");
+        resync(m);
+    }
+}
+
+MessageStats& Server::getMessageStats() noexcept
+{
+    return messageStats();
+}
+
+const RouteTable* Server::getRouteTable() noexcept
+{
+    return routeTable();
+}
+
+NeighborTable* Server::getNeighborTable() noexcept
+{
+    return neighborTable();
+}
+
+void Server::updateFilter(Manager& manager)
+{
+    // Runs after every batch of events, the generation saves rebuilding the
+    // set when nothing was ignored or unignored
+    const auto gen = manager.intfs.getIgnoredGeneration();
+    if (filterStats.updates > 0 && filteredGeneration == gen)
+    {
+        return;
+    }
+    filteredGeneration = gen;
+    auto ignored = manager.intfs.ignoredIntfs();
+    std::unordered_set<unsigned> cur(ignored.begin(), ignored.end());
+    if (filterStats.updates > 0 && filtered == cur)
+    {
+        return;
+    }
+    auto old = std::exchange(filtered, std::move(cur));
+    filterStats.updates++;
+    filterStats.ignoredIntfs = std::min(filtered.size(), maxFilteredIntfs);
+
+    auto prog = eventFilter(filtered, routeTable() != nullptr,
+                            neighborTable() != nullptr);
+    sock_fprog fprog{};
+    fprog.len = prog.size();
+    fprog.filter = prog.data();
+    if (setsockopt(sock.get(), SOL_SOCKET, SO_ATTACH_FILTER, &fprog,
+                   sizeof(fprog)) < 0)
+    {
+        filterStats.failures++;
+        lg2::warning("Failed to attach netlink event filter: {ERROR}",
+                     "ERROR", std::system_category().message(errno));
+    }
+
+    // An ifindex reused by a tracked interface may have had events dropped
+    // by the previous filter
+    for (auto ifidx : old)
+    {
+        if (!filtered.contains(ifidx) && manager.hasIntf(ifidx))
+        {
+            try
+            {
+                redumpIntf(manager, ifidx);
+            }
+            catch (const std::exception& e)
+            {
+                lg2::error("Failed to re-dump {NET_IDX}: {ERROR}", "NET_IDX",
+                           ifidx, "ERROR", e);
+            }
+        }
+    }
 }
 
 static stdplus::ManagedFd makeSock()
@@ -124,28 +664,62 @@ static stdplus::ManagedFd makeSock()
 
     sock.fcntlSetfl(sock.fcntlGetfl().set(FileFlag::NonBlock));
 
+    // Bursts of events must not overrun the socket, forcing the size lets it
+    // exceed rmem_max when we are privileged enough to do so
+    int rcvbuf = eventSockRcvBuf;
+    if (setsockopt(sock.get(), SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+                   sizeof(rcvbuf)) < 0 &&
+        setsockopt(sock.get(), SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+                   sizeof(rcvbuf)) < 0)
+    {
+        lg2::warning("Failed to size netlink event socket: {ERROR}", "ERROR",
+                     std::system_category().message(errno));
+    }
+
     sockaddr_nl local{};
     local.nl_family = AF_NETLINK;
     local.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR |
                       RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE | RTMGRP_NEIGH;
     bind(sock, local);
 
+    // Lets the kernel apply the filters of the dumps taken on this socket
+    int one = 1;
+    setsockopt(sock.get(), SOL_NETLINK, NETLINK_GET_STRICT_CHK, &one,
+               sizeof(one));
+
     return sock;
 }
 
 Server::Server(sdeventplus::Event& event, Manager& manager) :
     sock(makeSock()),
-    io(event, sock.get(), EPOLLIN | EPOLLET, [&](auto&&... args) {
-        return eventHandler(manager, std::forward<decltype(args)>(args)...);
-    })
+    io(event, sock.get(), EPOLLIN | EPOLLET,
+       [&](auto&&... args) {
+           if (reader)
+           {
+               readerHandler(manager, *reader, events);
+           }
+           else
+           {
+               eventHandler(manager, rx, events,
+                            std::forward<decltype(args)>(args)...);
+           }
+           updateFilter(manager);
+       })
 {
-    auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
-        handler(manager, hdr, data);
-    };
-    performRequest(NETLINK_ROUTE, RTM_GETLINK, NLM_F_DUMP, ifinfomsg{}, cb);
-    performRequest(NETLINK_ROUTE, RTM_GETADDR, NLM_F_DUMP, ifaddrmsg{}, cb);
-    performRequest(NETLINK_ROUTE, RTM_GETROUTE, NLM_F_DUMP, rtmsg{}, cb);
-    performRequest(NETLINK_ROUTE, RTM_GETNEIGH, NLM_F_DUMP, ndmsg{}, cb);
+    if (initialDump(manager, sock.get(), events))
+    {
+        lg2::info("Initial netlink dump was interrupted, resyncing");
+        resync(manager);
+    }
+    updateFilter(manager);
+    // 读取线程在 dump 完成后才启动，以免与 dump 争抢同一个套接字
+    if (NETLINK_READER_THREAD)
+    {
+        reader = std::make_unique<EventReader>(sock.get(), eventQueueDepth,
+                                               &messageStats(),
+                                               routeTable() != nullptr);
+        io.set_fd(reader->getWakeFd());
+    }
 }
 
 } // namespace phosphor::network::netlink
@@ -1,13 +1,24 @@
 #pragma once
+#include "event_coalescer.hpp"
+#include "netlink.hpp"
+#include "netlink_reader.hpp"
+#include "netlink_stats.hpp"
+
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/source/io.hpp>
 #include <stdplus/fd/managed.hpp>
 
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+
 namespace phosphor
 {
 namespace network
 {
 class Manager;
+class NeighborTable;
+class RouteTable;
 namespace netlink
 {
 
@@ -21,7 +32,9 @@ class Server
   public:
     /** @brief Constructor
      *
-     *  @details Sets up the server to handle incoming RTNETLINK events
+     *  @details Sets up the server to handle incoming RTNETLINK events.
+     *           The initial state is dumped on the subscribed socket so
+     *           every object is learned exactly once.
      *
      *  @param[in] eventPtr - Unique ptr reference to sd_event.
      *  @param[in] manager  - The network manager that receives updates
@@ -34,9 +47,69 @@ class Server
         return sock;
     }
 
+    /** @brief Counters describing the in-kernel event filter */
+    struct FilterStats
+    {
+        size_t updates = 0;
+        size_t failures = 0;
+        size_t ignoredIntfs = 0;
+    };
+
+    /** @brief Gets the counters of the in-kernel event filter */
+    inline const FilterStats& getFilterStats() const noexcept
+    {
+        return filterStats;
+    }
+
+    /** @brief Gets the per message type counters of the handlers */
+    static MessageStats& getMessageStats() noexcept;
+
+    /** @brief Gets the mirror of every kernel route
+     *
+     *  @return nullptr unless the route cache is enabled
+     */
+    static const RouteTable* getRouteTable() noexcept;
+
+    /** @brief Gets the mirror of every kernel neighbor
+     *
+     *  @return nullptr unless the neighbor cache is enabled
+     */
+    static NeighborTable* getNeighborTable() noexcept;
+
+    /** @brief Gets the counters of the event coalescing stage */
+    inline const EventCoalescer::Stats& getCoalesceStats() const noexcept
+    {
+        return events.getStats();
+    }
+
+    /** @brief Gets the batching counters of the event socket reader when
+     *         events are read on the event loop
+     */
+    inline const BatchReceiver::Stats& getStats() const noexcept
+    {
+        return rx.getStats();
+    }
+
+    /** @brief Gets the queue counters of the reader thread, all zero when
+     *         events are read on the event loop
+     */
+    inline EventReader::Stats getReaderStats() const noexcept
+    {
+        return reader ? reader->getStats() : EventReader::Stats{};
+    }
+
   private:
     stdplus::ManagedFd sock;
+    BatchReceiver rx;
+    EventCoalescer events;
+    std::unique_ptr<EventReader> reader;
+    std::unordered_set<unsigned> filtered;
+    uint64_t filteredGeneration = 0;
+    FilterStats filterStats;
     sdeventplus::source::IO io;
+
+    /** @brief Rebuilds the event filter if the ignored interfaces changed */
+    void updateFilter(Manager& manager);
 };
 
 } // namespace netlink
@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace phosphor::network
+{
+
+/** @class SpscRing
+ *  @brief A bounded lock-free queue for exactly one producer thread and one
+ *         consumer thread
+ *
+ *  @details The capacity is rounded up to a power of two so indices wrap
+ *           with a mask. The head and tail counters only ever grow and each
+ *           is written by a single side, which publishes its slot accesses
+ *           with a release store.
+ */
+template <typename T>
+class SpscRing
+{
+  public:
+    /** @brief Constructor
+     *
+     *  @param[in] capacity - The minimum number of queued elements
+     */
+    explicit SpscRing(size_t capacity) :
+        slots(std::bit_ceil(std::max<size_t>(capacity, 1))),
+        mask(slots.size() - 1)
+    {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /** @brief Queues an element, only called by the producer
+     *
+     *  @param[in] v - The element, left untouched if the ring is full
+     *  @return False if the ring is full
+     */
+    bool push(T&& v)
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size())
+        {
+            return false;
+        }
+        slots[t & mask] = std::move(v);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Dequeues the oldest element, only called by the consumer */
+    std::optional<T> pop()
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+        {
+            return std::nullopt;
+        }
+        std::optional<T> ret(std::move(slots[h & mask]));
+        head.store(h + 1, std::memory_order_release);
+        return ret;
+    }
+
+    /** @brief The number of queued elements, exact only from either side
+     *         while the other is idle
+     */
+    inline size_t size() const noexcept
+    {
+        return tail.load(std::memory_order_acquire) -
+               head.load(std::memory_order_acquire);
+    }
+
+    inline size_t capacity() const noexcept
+    {
+        return slots.size();
+    }
+
+  private:
+    std::vector<T> slots;
+    size_t mask;
+    /** @brief Each counter sits on its own cache line so the two sides
+     *         don't contend when they only touch their own
+     */
+    alignas(64) std::atomic<size_t> head = 0;
+    alignas(64) std::atomic<size_t> tail = 0;
+};
+
+} // namespace phosphor::network
@@ -2,6 +2,7 @@
 
 #include "ethernet_interface.hpp"
 #include "network_manager.hpp"
+#include "system_queries.hpp"
 
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
@@ -49,13 +50,17 @@ void StaticGateway::delete_()
     {
         if (it->second.get() == this)
         {
+            parent.get().applyNow("static gateway removal", [&](unsigned idx) {
+                system::deleteDefaultRoute(
+                    idx, stdplus::fromStr<stdplus::InAnyAddr>(it->first));
+            });
             ptr = std::move(it->second);
             staticGateways.erase(it);
             break;
         }
     }
 
-    parent.get().writeConfigurationFile();
+    parent.get().markConfigDirty();
     parent.get().manager.get().reloadConfigs();
 }
 
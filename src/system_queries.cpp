@@ -1,22 +1,28 @@
 #include "system_queries.hpp"
 
 #include "netlink.hpp"
+#include "netlink_async.hpp"
 
 #include <linux/ethtool.h>
 #include <linux/rtnetlink.h>
 #include <linux/sockios.h>
 #include <net/if.h>
+#include <netinet/in.h>
 
 #include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
 #include <stdplus/fd/create.hpp>
 #include <stdplus/hash/tuple.hpp>
 #include <stdplus/util/cexec.hpp>
 
 #include <algorithm>
-#include <format>
+#include <chrono>
+#include <cstring>
 #include <optional>
 #include <stdexcept>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <unordered_set>
 
 namespace phosphor::network::system
@@ -24,6 +30,9 @@ namespace phosphor::network::system
 
 using std::literals::string_view_literals::operator""sv;
 
+/** @brief Upper bound on how long the kernel may take to apply a change */
+constexpr auto requestTimeout = std::chrono::seconds(5);
+
 static stdplus::Fd& getIFSock()
 {
     using namespace stdplus::fd;
@@ -32,6 +41,13 @@ static stdplus::Fd& getIFSock()
     return fd;
 }
 
+static netlink::AsyncRequester& getRouteRequester()
+{
+    static netlink::AsyncRequester req(sdeventplus::Event::get_default(),
+                                       NETLINK_ROUTE);
+    return req;
+}
+
 static ifreq makeIFReq(std::string_view ifname)
 {
     ifreq ifr = {};
@@ -112,6 +128,166 @@ void setNICUp(std::string_view ifname, bool up)
     getIFSock().ioctl(SIOCSIFFLAGS, &ifr);
 }
 
+template <typename Addr>
+static constexpr uint8_t familyOf(const Addr&) noexcept
+{
+    return std::is_same_v<Addr, stdplus::In4Addr> ? AF_INET : AF_INET6;
+}
+
+/** @brief Whether an error means the kernel is already in the state a
+ *         change asked for
+ */
+static bool alreadyApplied(uint16_t type, uint16_t flags, int err)
+{
+    switch (type)
+    {
+        case RTM_DELADDR:
+        case RTM_DELROUTE:
+        case RTM_DELNEIGH:
+            return err == ESRCH || err == ENOENT || err == EADDRNOTAVAIL;
+    }
+    // Only an exclusive create fails on an existing object
+    return err == EEXIST && (flags & NLM_F_CREATE) && !(flags & NLM_F_REPLACE);
+}
+
+/** @brief Sends a change without waiting on the kernel, the outcome is
+ *         logged once its ack arrives
+ */
+static void commit(netlink::MsgBuilder& msgs, uint16_t type, uint16_t flags,
+                   unsigned ifidx, const char* what)
+{
+    auto buf = msgs.finish();
+    auto start = std::chrono::steady_clock::now();
+    getRouteRequester().send(
+        buf.data(), buf.size(), requestTimeout, {},
+        [type, flags, ifidx, what, start](int err) {
+            if (err != 0 && !alreadyApplied(type, flags, err))
+            {
+                lg2::error("Failed to apply {WHAT} on {NET_IDX}, waiting for "
+                           "networkd: {ERROR}",
+                           "WHAT", what, "NET_IDX", ifidx, "ERROR",
+                           strerror(err));
+                return;
+            }
+            auto took = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            lg2::info("Applied {WHAT} on {NET_IDX} in {US}us", "WHAT", what,
+                      "NET_IDX", ifidx, "US", took.count());
+        });
+}
+
+static void changeAddress(uint16_t type, uint16_t flags, unsigned ifidx,
+                          stdplus::SubnetAny ifaddr)
+{
+    netlink::MsgBuilder msgs;
+    std::visit(
+        [&](const auto& addr) {
+            using T = std::decay_t<decltype(addr)>;
+            ifaddrmsg msg = {};
+            msg.ifa_family = familyOf(addr);
+            msg.ifa_prefixlen = ifaddr.getPfx();
+            msg.ifa_scope = RT_SCOPE_UNIVERSE;
+            msg.ifa_index = ifidx;
+            msgs.begin(type, flags, msg)
+                .attr(IFA_LOCAL, addr)
+                .attr(IFA_ADDRESS, addr);
+            // Match networkd, which sets the broadcast address when there
+            // are hosts to broadcast to
+            if constexpr (std::is_same_v<T, stdplus::In4Addr>)
+            {
+                if (type == RTM_NEWADDR && ifaddr.getPfx() <= 30)
+                {
+                    auto brd = addr;
+                    brd.s_addr |= htonl(0xffffffffu >> ifaddr.getPfx());
+                    msgs.attr(IFA_BROADCAST, brd);
+                }
+            }
+        },
+        ifaddr.getAddr());
+    commit(msgs, type, flags, ifidx, "address");
+}
+
+void addAddress(unsigned ifidx, stdplus::SubnetAny ifaddr)
+{
+    changeAddress(RTM_NEWADDR, NLM_F_CREATE | NLM_F_REPLACE, ifidx, ifaddr);
+}
+
+void deleteAddress(unsigned ifidx, stdplus::SubnetAny ifaddr)
+{
+    changeAddress(RTM_DELADDR, 0, ifidx, ifaddr);
+}
+
+static void changeDefaultRoute(uint16_t type, uint16_t flags, unsigned ifidx,
+                               stdplus::InAnyAddr gw, bool onlink)
+{
+    netlink::MsgBuilder msgs;
+    std::visit(
+        [&](const auto& addr) {
+            rtmsg msg = {};
+            msg.rtm_family = familyOf(addr);
+            msg.rtm_table = RT_TABLE_MAIN;
+            msg.rtm_type = RTN_UNICAST;
+            if (type == RTM_NEWROUTE)
+            {
+                msg.rtm_protocol = RTPROT_STATIC;
+                msg.rtm_scope = RT_SCOPE_UNIVERSE;
+            }
+            else
+            {
+                msg.rtm_scope = RT_SCOPE_NOWHERE;
+            }
+            msg.rtm_flags = onlink ? RTNH_F_ONLINK : 0;
+            msgs.begin(type, flags, msg)
+                .attr(RTA_GATEWAY, addr)
+                .attr(RTA_OIF, uint32_t{ifidx});
+        },
+        gw);
+    commit(msgs, type, flags, ifidx, "route");
+}
+
+void addDefaultRoute(unsigned ifidx, stdplus::InAnyAddr gw, bool onlink)
+{
+    changeDefaultRoute(RTM_NEWROUTE, NLM_F_CREATE, ifidx, gw, onlink);
+}
+
+void deleteDefaultRoute(unsigned ifidx, stdplus::InAnyAddr gw)
+{
+    changeDefaultRoute(RTM_DELROUTE, 0, ifidx, gw, false);
+}
+
+static void changeNeighbor(uint16_t type, uint16_t flags, unsigned ifidx,
+                           stdplus::InAnyAddr addr,
+                           std::optional<stdplus::EtherAddr> mac)
+{
+    netlink::MsgBuilder msgs;
+    std::visit(
+        [&](const auto& addr) {
+            ndmsg msg = {};
+            msg.ndm_family = familyOf(addr);
+            msg.ndm_ifindex = ifidx;
+            msg.ndm_state = NUD_PERMANENT;
+            msgs.begin(type, flags, msg).attr(NDA_DST, addr);
+        },
+        addr);
+    if (mac)
+    {
+        msgs.attr(NDA_LLADDR, *mac);
+    }
+    commit(msgs, type, flags, ifidx, "neighbor");
+}
+
+void addNeighbor(unsigned ifidx, stdplus::InAnyAddr addr,
+                 stdplus::EtherAddr mac)
+{
+    changeNeighbor(RTM_NEWNEIGH, NLM_F_CREATE | NLM_F_REPLACE, ifidx, addr,
+                   mac);
+}
+
+void deleteNeighbor(unsigned ifidx, stdplus::InAnyAddr addr)
+{
+    changeNeighbor(RTM_DELNEIGH, 0, ifidx, addr, std::nullopt);
+}
+
 void deleteIntf(unsigned idx)
 {
     if (idx == 0)
@@ -121,16 +297,13 @@ void deleteIntf(unsigned idx)
     ifinfomsg msg = {};
     msg.ifi_family = AF_UNSPEC;
     msg.ifi_index = idx;
-    netlink::performRequest(
-        NETLINK_ROUTE, RTM_DELLINK, NLM_F_REPLACE, msg,
-        [&](const nlmsghdr& hdr, std::string_view data) {
-            int err = 0;
-            if (hdr.nlmsg_type == NLMSG_ERROR)
+    getRouteRequester().request(
+        RTM_DELLINK, NLM_F_REPLACE, msg, requestTimeout, {}, [idx](int err) {
+            if (err != 0)
             {
-                err = netlink::extractRtData<nlmsgerr>(data).error;
+                lg2::error("Failed to delete {NET_IDX}: {ERROR}", "NET_IDX",
+                           idx, "ERROR", strerror(err));
             }
-            throw std::runtime_error(
-                std::format("Failed to delete `{}`: {}", idx, strerror(err)));
         });
 }
 
@@ -19,6 +19,32 @@ void setMTU(std::string_view ifname, unsigned mtu);
 
 void setNICUp(std::string_view ifname, bool up);
 
+/** @brief Adds a static address to a link, or updates it if present
+ *
+ *  @details The changes below are sent without waiting for the kernel.
+ *           Its answer is logged once it arrives, and a change that finds
+ *           the kernel already in the requested state succeeds. Only a
+ *           failure to send throws.
+ */
+void addAddress(unsigned ifidx, stdplus::SubnetAny ifaddr);
+void deleteAddress(unsigned ifidx, stdplus::SubnetAny ifaddr);
+
+/** @brief Adds a default route through a gateway on a link
+ *
+ *  @param[in] onlink - Whether the gateway is reachable without a prefix
+ *                      covering it
+ */
+void addDefaultRoute(unsigned ifidx, stdplus::InAnyAddr gw, bool onlink);
+void deleteDefaultRoute(unsigned ifidx, stdplus::InAnyAddr gw);
+
+/** @brief Adds a permanent neighbor to a link, or updates it if present */
+void addNeighbor(unsigned ifidx, stdplus::InAnyAddr addr,
+                 stdplus::EtherAddr mac);
+void deleteNeighbor(unsigned ifidx, stdplus::InAnyAddr addr);
+
+/** @brief Asks the kernel to delete the link without waiting for the
+ *         outcome, failures are logged once the reply arrives
+ */
 void deleteIntf(unsigned idx);
 
 } // namespace phosphor::network::system
@@ -5,9 +5,11 @@
 #include <stdplus/net/addr/subnet.hpp>
 
 #include <array>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace phosphor::network
 {
@@ -94,6 +96,36 @@ struct StaticGatewayInfo
     }
 };
 
+/** @class NextHop
+ *  @brief One path of a route from the kernel
+ */
+struct NextHop
+{
+    unsigned ifidx;
+    std::optional<stdplus::InAnyAddr> gateway = std::nullopt;
+    uint16_t weight = 1;
+
+    bool operator==(const NextHop& rhs) const noexcept = default;
+};
+
+/** @class RouteInfo
+ *  @brief Information about a route in any table from the kernel
+ */
+struct RouteInfo
+{
+    uint32_t table;
+    stdplus::SubnetAny dst;
+    uint8_t tos = 0;
+    uint32_t priority = 0;
+    uint8_t protocol = 0;
+    uint8_t scope = 0;
+    uint8_t type = 0;
+    std::optional<uint32_t> mtu = std::nullopt;
+    std::vector<NextHop> nextHops = {};
+
+    bool operator==(const RouteInfo& rhs) const noexcept = default;
+};
+
 /** @brief Contains all of the object information about the interface */
 struct AllIntfInfo
 {
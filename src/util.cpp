@@ -5,7 +5,11 @@
 #include "config_parser.hpp"
 #include "types.hpp"
 
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/lg2.hpp>
@@ -14,7 +18,9 @@
 #include <stdplus/str/cat.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <fstream>
 #include <string>
 #include <string_view>
@@ -32,7 +38,44 @@ static constexpr std::string_view lldpdConfigFilePath = "/etc/lldpd.conf";
 namespace internal
 {
 
-void executeCommandinChildProcess(stdplus::zstring_view path, char** args)
+/* @brief waits for a child to exit, killing it once the timeout passes.
+ * @param[in] pid - the child to wait for.
+ * @param[in] timeout - how long the child may run.
+ * @return false if the child had to be killed.
+ */
+static bool waitOrKill(pid_t pid, std::chrono::milliseconds timeout)
+{
+    // glibc only declares pidfd_open() for C++ since 2.37
+    int fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (fd < 0)
+    {
+        // Without a pidfd the wait cannot be bounded
+        return true;
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    int r;
+    do
+    {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+        r = poll(&pfd, 1,
+                 static_cast<int>(
+                     std::max(left, std::chrono::milliseconds::zero())
+                         .count()));
+    } while (r < 0 && errno == EINTR);
+    close(fd);
+    if (r == 0)
+    {
+        kill(pid, SIGKILL);
+        return false;
+    }
+    return true;
+}
+
+int executeCommandinChildProcess(
+    stdplus::zstring_view path, char** args,
+    std::optional<std::chrono::milliseconds> timeout)
 {
     using namespace std::string_literals;
     pid_t pid = fork();
@@ -48,32 +91,44 @@ void executeCommandinChildProcess(stdplus::zstring_view path, char** args)
         lg2::error("Error occurred during fork: {ERRNO}", "ERRNO", error);
         elog<InternalFailure>();
     }
-    else if (pid > 0)
+
+    bool exited = !timeout || waitOrKill(pid, *timeout);
+    int status;
+    while (waitpid(pid, &status, 0) == -1)
     {
-        int status;
-        while (waitpid(pid, &status, 0) == -1)
+        if (errno != EINTR)
         {
-            if (errno != EINTR)
-            {
-                status = -1;
-                break;
-            }
+            status = -1;
+            break;
         }
+    }
 
-        if (status < 0)
+    if (status < 0 || !exited)
+    {
+        stdplus::StrBuf buf;
+        stdplus::strAppend(buf, "`"sv, path, "`"sv);
+        for (size_t i = 0; args[i] != nullptr; ++i)
+        {
+            stdplus::strAppend(buf, " `"sv, args[i], "`"sv);
+        }
+        buf.push_back('\0');
+        if (!exited)
+        {
+            lg2::error("Timed out executing the command {CMD}", "CMD",
+                       buf.data());
+        }
+        else
         {
-            stdplus::StrBuf buf;
-            stdplus::strAppend(buf, "`"sv, path, "`"sv);
-            for (size_t i = 0; args[i] != nullptr; ++i)
-            {
-                stdplus::strAppend(buf, " `"sv, args[i], "`"sv);
-            }
-            buf.push_back('\0');
             lg2::error("Unable to execute the command {CMD}: {STATUS}", "CMD",
                        buf.data(), "STATUS", status);
-            elog<InternalFailure>();
         }
+        elog<InternalFailure>();
+    }
+    if (WIFSIGNALED(status))
+    {
+        return 128 + WTERMSIG(status);
     }
+    return WEXITSTATUS(status);
 }
 
 /** @brief Get ignored interfaces from environment */
@@ -4,6 +4,7 @@
 #include <stdplus/raw.hpp>
 #include <stdplus/zstring_view.hpp>
 
+#include <chrono>
 #include <map>
 #include <optional>
 #include <string>
@@ -83,8 +84,14 @@ namespace internal
 /* @brief runs the given command in child process.
  * @param[in] path - path of the binary file which needs to be execeuted.
  * @param[in] args - arguments of the command.
+ * @param[in] timeout - how long the command may run before it is killed,
+ *                      unbounded if unset.
+ * @return the exit status of the command, 128 plus the signal number if
+ *         it was killed by one.
  */
-void executeCommandinChildProcess(stdplus::zstring_view path, char** args);
+int executeCommandinChildProcess(
+    stdplus::zstring_view path, char** args,
+    std::optional<std::chrono::milliseconds> timeout = std::nullopt);
 
 /** @brief Get ignored interfaces from environment */
 std::string_view getIgnoredInterfacesEnv();
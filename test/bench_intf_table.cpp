@@ -0,0 +1,136 @@
+#include "network_manager.hpp"
+
+#include <net/if_arp.h>
+#include <stdlib.h>
+
+#include <sdbusplus/bus.hpp>
+#include <stdplus/pinned.hpp>
+
+#include <filesystem>
+#include <format>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace phosphor::network
+{
+
+using stdplus::operator""_sub;
+
+struct NoopExecutor : DelayedExecutor
+{
+    void schedule() override {}
+    void setCallback(fu2::unique_function<void()>&&) override {}
+};
+
+static std::filesystem::path makeDir()
+{
+    auto tmpl = (std::filesystem::temp_directory_path() /
+                 "phosphor-networkd-bench.XXXXXX")
+                    .string();
+    if (mkdtemp(tmpl.data()) == nullptr)
+    {
+        throw std::runtime_error("mkdtemp");
+    }
+    return tmpl;
+}
+
+static InterfaceInfo link(unsigned idx)
+{
+    return InterfaceInfo{.type = ARPHRD_ETHER,
+                         .idx = idx,
+                         .flags = 0,
+                         .name = std::format("eth{}", idx)};
+}
+
+/** @brief The ifindexes a stream of events refers to */
+static std::vector<unsigned> eventIdxs(unsigned intfs)
+{
+    std::mt19937 rng(intfs);
+    std::uniform_int_distribution<unsigned> dist(1, intfs);
+    std::vector<unsigned> ret(1024);
+    for (auto& idx : ret)
+    {
+        idx = dist(rng);
+    }
+    return ret;
+}
+
+/** @brief A manager knowing about a number of ethernet links, none of them
+ *         managed so events only touch the per-interface state
+ */
+struct Dispatch
+{
+    std::filesystem::path dir = makeDir();
+    stdplus::Pinned<sdbusplus::bus_t> bus{sdbusplus::bus::new_default()};
+    stdplus::Pinned<NoopExecutor> reload;
+    Manager manager{bus, reload, "/xyz/openbmc_test/bench", dir};
+
+    explicit Dispatch(unsigned intfs)
+    {
+        for (unsigned i = 1; i <= intfs; ++i)
+        {
+            manager.addInterface(link(i));
+        }
+    }
+
+    ~Dispatch()
+    {
+        std::filesystem::remove_all(dir);
+    }
+};
+
+/** @brief Link refreshes, as the kernel sends on every flag or counter
+ *         change, for existing interfaces
+ */
+static void BM_DispatchLink(benchmark::State& state)
+{
+    const auto n = static_cast<unsigned>(state.range(0));
+    Dispatch d(n);
+    auto idxs = eventIdxs(n);
+    std::vector<InterfaceInfo> events;
+    for (auto idx : idxs)
+    {
+        events.push_back(link(idx));
+    }
+    for (auto _ : state)
+    {
+        for (const auto& e : events)
+        {
+            d.manager.addInterface(e);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_DispatchLink)->Arg(1)->Arg(64)->Arg(4096);
+
+/** @brief Address add and delete events for each interface */
+static void BM_DispatchAddress(benchmark::State& state)
+{
+    const auto n = static_cast<unsigned>(state.range(0));
+    Dispatch d(n);
+    auto idxs = eventIdxs(n);
+    std::vector<AddressInfo> events;
+    for (auto idx : idxs)
+    {
+        events.push_back(AddressInfo{
+            .ifidx = idx, .ifaddr = "10.0.0.1/24"_sub, .scope = 0, .flags = 0});
+    }
+    for (auto _ : state)
+    {
+        for (const auto& e : events)
+        {
+            d.manager.addAddress(e);
+            d.manager.removeAddress(e);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events.size() * 2);
+}
+BENCHMARK(BM_DispatchAddress)->Arg(1)->Arg(64)->Arg(4096);
+
+} // namespace phosphor::network
+
+BENCHMARK_MAIN();
@@ -0,0 +1,178 @@
+#include "netlink.hpp"
+
+#include <dlfcn.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <string_view>
+#include <system_error>
+
+#include <benchmark/benchmark.h>
+
+/** @brief Socket syscalls made by the process, counted by the wrappers
+ *         below which forward to the real calls
+ */
+static size_t syscalls = 0;
+
+template <typename F>
+static F next(const char* name)
+{
+    return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+
+extern "C"
+{
+
+int socket(int domain, int type, int protocol)
+{
+    static auto real = next<decltype(&socket)>("socket");
+    syscalls++;
+    return real(domain, type, protocol);
+}
+
+int setsockopt(int sockfd, int level, int optname, const void* optval,
+               socklen_t optlen)
+{
+    static auto real = next<decltype(&setsockopt)>("setsockopt");
+    syscalls++;
+    return real(sockfd, level, optname, optval, optlen);
+}
+
+int bind(int sockfd, const struct sockaddr* addr, socklen_t addrlen)
+{
+    static auto real = next<decltype(&bind)>("bind");
+    syscalls++;
+    return real(sockfd, addr, addrlen);
+}
+
+int close(int fd)
+{
+    static auto real = next<decltype(&close)>("close");
+    syscalls++;
+    return real(fd);
+}
+
+ssize_t sendmsg(int sockfd, const struct msghdr* msg, int flags)
+{
+    static auto real = next<decltype(&sendmsg)>("sendmsg");
+    syscalls++;
+    return real(sockfd, msg, flags);
+}
+
+ssize_t recvmsg(int sockfd, struct msghdr* msg, int flags)
+{
+    static auto real = next<decltype(&recvmsg)>("recvmsg");
+    syscalls++;
+    return real(sockfd, msg, flags);
+}
+
+} // extern "C"
+
+namespace phosphor::network::netlink
+{
+
+static void check(bool ok, const char* msg)
+{
+    if (!ok)
+    {
+        throw std::system_error(errno, std::generic_category(), msg);
+    }
+}
+
+/** @brief Takes a link dump the way every request did before the pool, on
+ *         a socket opened and bound for it and closed afterwards
+ *
+ *  @return The number of links dumped
+ */
+static size_t freshRequest()
+{
+    int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    check(sock >= 0, "socket");
+    int strict = 1;
+    setsockopt(sock, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &strict,
+               sizeof(strict));
+    sockaddr_nl local{};
+    local.nl_family = AF_NETLINK;
+    check(bind(sock, reinterpret_cast<sockaddr*>(&local), sizeof(local)) == 0,
+          "bind");
+
+    struct
+    {
+        nlmsghdr hdr;
+        ifinfomsg msg;
+    } req{};
+    req.hdr.nlmsg_len = sizeof(req);
+    req.hdr.nlmsg_type = RTM_GETLINK;
+    req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | NLM_F_DUMP;
+    req.hdr.nlmsg_seq = 1;
+
+    sockaddr_nl dst{};
+    dst.nl_family = AF_NETLINK;
+    iovec iov{&req, sizeof(req)};
+    msghdr hdr{};
+    hdr.msg_name = &dst;
+    hdr.msg_namelen = sizeof(dst);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    check(sendmsg(sock, &hdr, 0) >= 0, "sendmsg");
+
+    std::array<char, 8192> buf;
+    size_t links = 0;
+    bool done = true;
+    do
+    {
+        iov = {buf.data(), buf.size()};
+        hdr.msg_namelen = sizeof(dst);
+        ssize_t recvd = recvmsg(sock, &hdr, 0);
+        check(recvd > 0, "recvmsg");
+        std::string_view msgs(buf.data(), recvd);
+        while (!msgs.empty())
+        {
+            detail::processMsg(msgs, done,
+                               [&](const nlmsghdr&, std::string_view) {
+                                   links++;
+                               });
+        }
+    } while (!done);
+
+    close(sock);
+    return links;
+}
+
+static void BM_RequestFreshSocket(benchmark::State& state)
+{
+    syscalls = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(freshRequest());
+    }
+    state.counters["syscalls"] =
+        benchmark::Counter(syscalls, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RequestFreshSocket);
+
+static void BM_RequestPooledSocket(benchmark::State& state)
+{
+    // The first request opens the socket the rest of them reuse
+    performRequest(NETLINK_ROUTE, RTM_GETLINK, NLM_F_DUMP, ifinfomsg{},
+                   [](const nlmsghdr&, std::string_view) {});
+    syscalls = 0;
+    for (auto _ : state)
+    {
+        size_t links = 0;
+        performRequest(NETLINK_ROUTE, RTM_GETLINK, NLM_F_DUMP, ifinfomsg{},
+                       [&](const nlmsghdr&, std::string_view) { links++; });
+        benchmark::DoNotOptimize(links);
+    }
+    state.counters["syscalls"] =
+        benchmark::Counter(syscalls, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RequestPooledSocket);
+
+} // namespace phosphor::network::netlink
+
+BENCHMARK_MAIN();
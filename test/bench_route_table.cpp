@@ -0,0 +1,110 @@
+#include "route_table.hpp"
+
+#include <arpa/inet.h>
+#include <linux/rtnetlink.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace phosphor::network
+{
+
+/** @brief Random IPv4 routes with the prefix lengths of a full feed slice,
+ *         each through its own interface
+ */
+static std::vector<RouteInfo> makeRoutes(size_t n)
+{
+    std::mt19937 rng(1);
+    std::vector<RouteInfo> ret;
+    ret.reserve(n);
+    while (ret.size() < n)
+    {
+        uint8_t len = 8 + rng() % 25;
+        uint32_t addr = rng() & ~(len == 32 ? 0 : 0xffffffffu >> len);
+        ret.push_back(RouteInfo{
+            .table = RT_TABLE_MAIN,
+            .dst = stdplus::SubnetAny{stdplus::In4Addr(in_addr{htonl(addr)}),
+                                      len},
+            .nextHops = {NextHop{.ifidx = static_cast<unsigned>(ret.size())}},
+        });
+    }
+    return ret;
+}
+
+static void BM_RouteInsert(benchmark::State& state)
+{
+    auto routes = makeRoutes(state.range(0));
+    for (auto _ : state)
+    {
+        // Includes copying each route, as add() takes ownership
+        auto t = std::make_unique<RouteTable>();
+        for (const auto& r : routes)
+        {
+            t->add(RouteInfo(r));
+        }
+        benchmark::DoNotOptimize(t->size());
+        state.PauseTiming();
+        t.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * routes.size());
+}
+BENCHMARK(BM_RouteInsert)->Arg(1000)->Arg(50000);
+
+static void BM_RouteLookup(benchmark::State& state)
+{
+    auto routes = makeRoutes(state.range(0));
+    RouteTable t;
+    for (const auto& r : routes)
+    {
+        t.add(RouteInfo(r));
+    }
+    std::mt19937 rng(2);
+    std::vector<stdplus::InAnyAddr> addrs;
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        auto addr = static_cast<in_addr_t>(rng());
+        addrs.push_back(stdplus::In4Addr(in_addr{addr}));
+    }
+    for (auto _ : state)
+    {
+        size_t hits = 0;
+        for (const auto& addr : addrs)
+        {
+            hits += t.lookup(addr) != nullptr;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+BENCHMARK(BM_RouteLookup)->Arg(1000)->Arg(50000);
+
+static void BM_RouteRemove(benchmark::State& state)
+{
+    auto routes = makeRoutes(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        RouteTable t;
+        for (const auto& r : routes)
+        {
+            t.add(RouteInfo(r));
+        }
+        state.ResumeTiming();
+        for (const auto& r : routes)
+        {
+            t.remove(r);
+        }
+        benchmark::DoNotOptimize(t.size());
+    }
+    state.SetItemsProcessed(state.iterations() * routes.size());
+}
+BENCHMARK(BM_RouteRemove)->Arg(1000)->Arg(50000);
+
+} // namespace phosphor::network
+
+BENCHMARK_MAIN();
@@ -0,0 +1,218 @@
+#include "netlink.hpp"
+#include "rtnetlink.hpp"
+
+#include <linux/if_arp.h>
+#include <linux/if_link.h>
+#include <linux/neighbour.h>
+#include <linux/rtnetlink.h>
+#include <netinet/in.h>
+
+#include <stdplus/net/addr/ether.hpp>
+#include <stdplus/net/addr/ip.hpp>
+#include <stdplus/raw.hpp>
+
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+namespace phosphor::network::netlink
+{
+
+/** @brief Builds a single message and keeps it alive for the benchmark
+ */
+class Msg
+{
+  public:
+    template <typename T>
+    Msg(uint16_t type, const T& msg)
+    {
+        builder.begin(type, 0, msg);
+    }
+
+    MsgBuilder* operator->()
+    {
+        return &builder;
+    }
+
+    /** @brief The payload following the nlmsghdr */
+    std::string_view payload()
+    {
+        auto buf = builder.finish();
+        return std::string_view(buf.data(), buf.size()).substr(NLMSG_HDRLEN);
+    }
+
+  private:
+    MsgBuilder builder;
+};
+
+/** @brief A link event carrying the attributes of a typical VLAN link */
+static Msg linkMsg()
+{
+    Msg ret(RTM_NEWLINK, ifinfomsg{.ifi_family = AF_UNSPEC,
+                                   .ifi_type = ARPHRD_ETHER,
+                                   .ifi_index = 3,
+                                   .ifi_flags = IFF_UP | IFF_RUNNING});
+    ret->attr(IFLA_IFNAME, std::string_view("eth0.100", 9))
+        .attr(IFLA_TXQLEN, uint32_t{1000})
+        .attr(IFLA_OPERSTATE, uint8_t{IF_OPER_UP})
+        .attr(IFLA_MTU, uint32_t{1500})
+        .attr(IFLA_LINK, uint32_t{2})
+        .attr(IFLA_ADDRESS, stdplus::EtherAddr{0, 1, 2, 3, 4, 5})
+        .attr(IFLA_BROADCAST,
+              stdplus::EtherAddr{0xff, 0xff, 0xff, 0xff, 0xff, 0xff})
+        .attr(IFLA_STATS64, rtnl_link_stats64{})
+        .beginNested(IFLA_LINKINFO)
+        .attr(IFLA_INFO_KIND, std::string_view("vlan", 5))
+        .beginNested(IFLA_INFO_DATA)
+        .attr(IFLA_VLAN_ID, uint16_t{100})
+        .endNested()
+        .endNested();
+    return ret;
+}
+
+static void BM_IntfFromRtm(benchmark::State& state)
+{
+    auto msg = linkMsg();
+    auto payload = msg.payload();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(intfFromRtm(payload));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IntfFromRtm);
+
+/** @brief Decodes a link the way intfFromRtm() did before the attribute
+ *         tables, switching on each attribute as it is walked
+ */
+[[gnu::noinline]] static InterfaceInfo walkLink(std::string_view msg)
+{
+    const auto& ifinfo = extractRtData<ifinfomsg>(msg);
+    InterfaceInfo ret;
+    ret.type = ifinfo.ifi_type;
+    ret.idx = ifinfo.ifi_index;
+    ret.flags = ifinfo.ifi_flags;
+    while (!msg.empty())
+    {
+        auto [hdr, data] = extractRtAttr(msg);
+        switch (hdr.rta_type)
+        {
+            case IFLA_IFNAME:
+                ret.name.emplace(data.begin(), data.end() - 1);
+                break;
+            case IFLA_ADDRESS:
+                if (data.size() == sizeof(stdplus::EtherAddr))
+                {
+                    ret.mac.emplace(
+                        stdplus::raw::copyFrom<stdplus::EtherAddr>(data));
+                }
+                break;
+            case IFLA_MTU:
+                ret.mtu.emplace(stdplus::raw::copyFrom<unsigned>(data));
+                break;
+            case IFLA_LINK:
+                ret.parent_idx.emplace(stdplus::raw::copyFrom<unsigned>(data));
+                break;
+            case IFLA_LINKINFO:
+                while (!data.empty())
+                {
+                    auto [infoHdr, info] = extractRtAttr(data);
+                    if (infoHdr.rta_type == IFLA_INFO_KIND)
+                    {
+                        ret.kind.emplace(info.begin(), info.end() - 1);
+                    }
+                    else if (infoHdr.rta_type == IFLA_INFO_DATA)
+                    {
+                        while (!info.empty())
+                        {
+                            auto [vlanHdr, vlan] = extractRtAttr(info);
+                            if (vlanHdr.rta_type == IFLA_VLAN_ID)
+                            {
+                                ret.vlan_id.emplace(
+                                    stdplus::raw::copyFrom<uint16_t>(vlan));
+                            }
+                        }
+                    }
+                }
+                break;
+        }
+    }
+    return ret;
+}
+
+static void BM_IntfWalk(benchmark::State& state)
+{
+    auto msg = linkMsg();
+    auto payload = msg.payload();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(walkLink(payload));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IntfWalk);
+
+static void BM_AddrFromRtm(benchmark::State& state)
+{
+    Msg msg(RTM_NEWADDR, ifaddrmsg{.ifa_family = AF_INET,
+                                   .ifa_prefixlen = 24,
+                                   .ifa_flags = IFA_F_PERMANENT,
+                                   .ifa_scope = RT_SCOPE_UNIVERSE,
+                                   .ifa_index = 3});
+    msg->attr(IFA_ADDRESS, stdplus::In4Addr{192, 168, 1, 10})
+        .attr(IFA_LOCAL, stdplus::In4Addr{192, 168, 1, 10})
+        .attr(IFA_BROADCAST, stdplus::In4Addr{192, 168, 1, 255})
+        .attr(IFA_LABEL, std::string_view("eth0", 5))
+        .attr(IFA_FLAGS, uint32_t{IFA_F_PERMANENT})
+        .attr(IFA_CACHEINFO, ifa_cacheinfo{});
+    auto payload = msg.payload();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(addrFromRtm(payload));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddrFromRtm);
+
+static void BM_NeighFromRtm(benchmark::State& state)
+{
+    Msg msg(RTM_NEWNEIGH, ndmsg{.ndm_family = AF_INET,
+                                .ndm_ifindex = 3,
+                                .ndm_state = NUD_PERMANENT});
+    msg->attr(NDA_DST, stdplus::In4Addr{192, 168, 1, 1})
+        .attr(NDA_LLADDR, stdplus::EtherAddr{0, 1, 2, 3, 4, 5})
+        .attr(NDA_CACHEINFO, nda_cacheinfo{})
+        .attr(NDA_PROBES, uint32_t{0});
+    auto payload = msg.payload();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(neighFromRtm(payload));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NeighFromRtm);
+
+static void BM_GatewayFromRtm(benchmark::State& state)
+{
+    Msg msg(RTM_NEWROUTE, rtmsg{.rtm_family = AF_INET,
+                                .rtm_table = RT_TABLE_MAIN,
+                                .rtm_protocol = RTPROT_STATIC,
+                                .rtm_scope = RT_SCOPE_UNIVERSE,
+                                .rtm_type = RTN_UNICAST});
+    msg->attr(RTA_TABLE, uint32_t{RT_TABLE_MAIN})
+        .attr(RTA_PRIORITY, uint32_t{1024})
+        .attr(RTA_GATEWAY, stdplus::In4Addr{192, 168, 1, 1})
+        .attr(RTA_OIF, uint32_t{3});
+    auto payload = msg.payload();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(gatewayFromRtm(payload));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GatewayFromRtm);
+
+} // namespace phosphor::network::netlink
+
+BENCHMARK_MAIN();
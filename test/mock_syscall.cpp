@@ -4,6 +4,7 @@
 
 #include <arpa/inet.h>
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <net/ethernet.h>
@@ -16,6 +17,7 @@
 
 #include <stdplus/raw.hpp>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
@@ -27,6 +29,10 @@
 #include <vector>
 
 std::map<int, std::queue<std::string>> mock_rtnetlinks;
+size_t mock_rtnetlink_opens = 0;
+std::vector<std::string> mock_requests;
+std::queue<std::string> mock_events;
+std::queue<std::string> mock_events_after;
 
 using phosphor::network::InterfaceInfo;
 
@@ -34,10 +40,32 @@ std::map<std::string, InterfaceInfo> mock_if;
 
 void phosphor::network::system::mock_clear()
 {
-    mock_rtnetlinks.clear();
+    // Sockets may be pooled across tests so only drop their pending data
+    for (auto& [_, msgs] : mock_rtnetlinks)
+    {
+        msgs = {};
+    }
+    mock_requests.clear();
+    mock_events = {};
+    mock_events_after = {};
     mock_if.clear();
 }
 
+size_t phosphor::network::system::mock_socketsOpened()
+{
+    return mock_rtnetlink_opens;
+}
+
+const std::vector<std::string>& phosphor::network::system::mock_nlRequests()
+{
+    return mock_requests;
+}
+
+void phosphor::network::system::mock_addEvent(std::string msg, bool afterDump)
+{
+    (afterDump ? mock_events_after : mock_events).emplace(std::move(msg));
+}
+
 void phosphor::network::system::mock_addIF(const InterfaceInfo& info)
 {
     if (info.idx == 0)
@@ -88,12 +116,13 @@ void appendRTAttr(std::string& msgBuf, unsigned short type,
 
 ssize_t sendmsg_link_dump(std::queue<std::string>& msgs, std::string_view in)
 {
-    if (const auto& hdrin = *reinterpret_cast<const nlmsghdr*>(in.data());
-        hdrin.nlmsg_type != RTM_GETLINK)
+    const auto& hdrin = *reinterpret_cast<const nlmsghdr*>(in.data());
+    if (hdrin.nlmsg_type != RTM_GETLINK)
     {
         return 0;
     }
 
+    const auto seq = hdrin.nlmsg_seq;
     std::string msgBuf;
     msgBuf.reserve(8192);
     for (const auto& [name, i] : mock_if)
@@ -101,6 +130,12 @@ ssize_t sendmsg_link_dump(std::queue<std::string>& msgs, std::string_view in)
         if (msgBuf.size() > 4096)
         {
             msgs.emplace(std::move(msgBuf));
+            msgBuf.clear();
+            if (!mock_events.empty())
+            {
+                msgs.emplace(std::move(mock_events.front()));
+                mock_events.pop();
+            }
         }
         const auto nlbegin = msgBuf.size();
         msgBuf.append(NLMSG_SPACE(sizeof(ifinfomsg)), '\0');
@@ -127,6 +162,7 @@ ssize_t sendmsg_link_dump(std::queue<std::string>& msgs, std::string_view in)
         hdr.nlmsg_len = msgBuf.size() - nlbegin;
         hdr.nlmsg_type = RTM_NEWLINK;
         hdr.nlmsg_flags = NLM_F_MULTI;
+        hdr.nlmsg_seq = seq;
         msgBuf.resize(NLMSG_ALIGN(msgBuf.size()), '\0');
     }
     const auto nlbegin = msgBuf.size();
@@ -135,23 +171,94 @@ ssize_t sendmsg_link_dump(std::queue<std::string>& msgs, std::string_view in)
     hdr.nlmsg_len = NLMSG_LENGTH(0);
     hdr.nlmsg_type = NLMSG_DONE;
     hdr.nlmsg_flags = NLM_F_MULTI;
+    hdr.nlmsg_seq = seq;
 
     msgs.emplace(std::move(msgBuf));
+    for (auto* events : {&mock_events, &mock_events_after})
+    {
+        for (; !events->empty(); events->pop())
+        {
+            msgs.emplace(std::move(events->front()));
+        }
+    }
     return in.size();
 }
 
 ssize_t sendmsg_ack(std::queue<std::string>& msgs, std::string_view in)
 {
     nlmsgerr ack{};
+    ack.msg = *reinterpret_cast<const nlmsghdr*>(in.data());
     nlmsghdr hdr{};
     hdr.nlmsg_len = NLMSG_LENGTH(sizeof(ack));
     hdr.nlmsg_type = NLMSG_ERROR;
+    hdr.nlmsg_seq = ack.msg.nlmsg_seq;
     auto& out = msgs.emplace(hdr.nlmsg_len, '\0');
     memcpy(out.data(), &hdr, sizeof(hdr));
     memcpy(NLMSG_DATA(out.data()), &ack, sizeof(ack));
     return in.size();
 }
 
+static ssize_t mock_recv(std::queue<std::string>& msgs, int sockfd,
+                         struct msghdr* msg, int flags)
+{
+    validateMsgHdr(msg);
+    if (msgs.empty())
+    {
+        if ((flags & MSG_DONTWAIT) || (fcntl(sockfd, F_GETFL) & O_NONBLOCK))
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+        fprintf(stderr, "No pending netlink responses\n");
+        abort();
+    }
+
+    // Queued replies are coalesced into datagrams of up to 8K, multicast
+    // events always arrive in a datagram of their own like from the kernel
+    constexpr size_t required_buf_size = 8192;
+    const auto seqOf = [](const std::string& msg) {
+        return reinterpret_cast<const nlmsghdr*>(msg.data())->nlmsg_seq;
+    };
+    const auto seq = seqOf(msgs.front());
+    const auto fits = [&](ssize_t ret, const std::string& msg) {
+        return (ret == 0 || (seq != 0 && seqOf(msg) == seq)) &&
+               NLMSG_ALIGN(ret) + msg.size() <= required_buf_size;
+    };
+    if ((flags & (MSG_PEEK | MSG_TRUNC)) == (MSG_PEEK | MSG_TRUNC))
+    {
+        auto peek = msgs;
+        ssize_t ret = 0;
+        while (!peek.empty() && fits(ret, peek.front()))
+        {
+            ret = NLMSG_ALIGN(ret) + peek.front().size();
+            peek.pop();
+        }
+        return ret;
+    }
+
+    if (msg->msg_iov[0].iov_len < required_buf_size)
+    {
+        fprintf(stderr, "recvmsg iov too short: %zu\n",
+                msg->msg_iov[0].iov_len);
+        abort();
+    }
+    ssize_t ret = 0;
+    auto data = reinterpret_cast<char*>(msg->msg_iov[0].iov_base);
+    while (!msgs.empty())
+    {
+        const auto& msg = msgs.front();
+        if (!fits(ret, msg))
+        {
+            break;
+        }
+        ret = NLMSG_ALIGN(ret);
+        memcpy(data + ret, msg.data(), msg.size());
+        ret += msg.size();
+        msgs.pop();
+    }
+    return ret;
+}
+
 extern "C"
 {
 int ioctl(int fd, unsigned long int request, ...)
@@ -208,6 +315,7 @@ int socket(int domain, int type, int protocol)
     if (domain == AF_NETLINK && protocol == NETLINK_ROUTE)
     {
         mock_rtnetlinks[fd] = {};
+        mock_rtnetlink_opens++;
     }
     return fd;
 }
@@ -243,24 +351,31 @@ ssize_t sendmsg(int sockfd, const struct msghdr* msg, int flags)
         abort();
     }
 
-    ssize_t ret;
     std::string_view iov(reinterpret_cast<char*>(msg->msg_iov[0].iov_base),
                          msg->msg_iov[0].iov_len);
 
-    ret = sendmsg_link_dump(msgs, iov);
-    if (ret != 0)
+    // Batched requests are answered one message at a time
+    while (!iov.empty())
     {
-        return ret;
-    }
+        const auto& hdr = *reinterpret_cast<const nlmsghdr*>(iov.data());
+        if (iov.size() < sizeof(hdr) || hdr.nlmsg_len < sizeof(hdr) ||
+            iov.size() < hdr.nlmsg_len)
+        {
+            fprintf(stderr, "sendmsg malformed nlmsg\n");
+            abort();
+        }
+        auto req = iov.substr(0, hdr.nlmsg_len);
+        iov.remove_prefix(
+            std::min<size_t>(NLMSG_ALIGN(hdr.nlmsg_len), iov.size()));
+        mock_requests.emplace_back(req);
 
-    ret = sendmsg_ack(msgs, iov);
-    if (ret != 0)
-    {
-        return ret;
+        if (sendmsg_link_dump(msgs, req) == 0 && sendmsg_ack(msgs, req) == 0)
+        {
+            errno = ENOSYS;
+            return -1;
+        }
     }
-
-    errno = ENOSYS;
-    return -1;
+    return msg->msg_iov[0].iov_len;
 }
 
 ssize_t recvmsg(int sockfd, struct msghdr* msg, int flags)
@@ -272,37 +387,41 @@ ssize_t recvmsg(int sockfd, struct msghdr* msg, int flags)
             reinterpret_cast<decltype(&recvmsg)>(dlsym(RTLD_NEXT, "recvmsg"));
         return real_recvmsg(sockfd, msg, flags);
     }
-    auto& msgs = it->second;
+    return mock_recv(it->second, sockfd, msg, flags);
+}
 
-    validateMsgHdr(msg);
-    constexpr size_t required_buf_size = 8192;
-    if (msg->msg_iov[0].iov_len < required_buf_size)
+int recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
+             struct timespec* timeout)
+{
+    auto it = mock_rtnetlinks.find(sockfd);
+    if (it == mock_rtnetlinks.end())
     {
-        fprintf(stderr, "recvmsg iov too short: %zu\n",
-                msg->msg_iov[0].iov_len);
-        abort();
+        static auto real_recvmmsg = reinterpret_cast<decltype(&recvmmsg)>(
+            dlsym(RTLD_NEXT, "recvmmsg"));
+        return real_recvmmsg(sockfd, msgvec, vlen, flags, timeout);
     }
-    if (msgs.empty())
+    if (flags & MSG_PEEK)
     {
-        fprintf(stderr, "No pending netlink responses\n");
+        fprintf(stderr, "recvmmsg peeking unsupported\n");
         abort();
     }
-
-    ssize_t ret = 0;
-    auto data = reinterpret_cast<char*>(msg->msg_iov[0].iov_base);
-    while (!msgs.empty())
+    unsigned int i = 0;
+    for (; i < vlen; ++i)
     {
-        const auto& msg = msgs.front();
-        if (NLMSG_ALIGN(ret) + msg.size() > required_buf_size)
+        // Only the first datagram may block, like the kernel
+        auto ret = mock_recv(it->second, sockfd, &msgvec[i].msg_hdr,
+                             i == 0 ? flags : flags | MSG_DONTWAIT);
+        if (ret < 0)
         {
+            if (i == 0)
+            {
+                return -1;
+            }
             break;
         }
-        ret = NLMSG_ALIGN(ret);
-        memcpy(data + ret, msg.data(), msg.size());
-        ret += msg.size();
-        msgs.pop();
+        msgvec[i].msg_len = ret;
     }
-    return ret;
+    return i;
 }
 
 } // extern "C"
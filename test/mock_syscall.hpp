@@ -1,6 +1,9 @@
 #pragma once
 #include "system_queries.hpp"
 
+#include <string>
+#include <vector>
+
 namespace phosphor::network::system
 {
 /** @brief Clears out the interfaces and IPs configured for mocking */
@@ -8,4 +11,17 @@ void mock_clear();
 
 /** @brief Adds an interface definition to the mock system */
 void mock_addIF(const InterfaceInfo& info);
+
+/** @brief Number of rtnetlink sockets the code under test has opened */
+size_t mock_socketsOpened();
+
+/** @brief Every rtnetlink message sent since the last mock_clear() */
+const std::vector<std::string>& mock_nlRequests();
+
+/** @brief Queues a multicast event, from port 0 with sequence 0, to be
+ *         delivered with the next link dump. Events go one at a time
+ *         between its reply datagrams, or after NLMSG_DONE if afterDump is
+ *         set or there are no boundaries left.
+ */
+void mock_addEvent(std::string msg, bool afterDump = false);
 } // namespace phosphor::network::system
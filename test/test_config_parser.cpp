@@ -74,6 +74,33 @@ TEST(TestTypeChecking, Key)
     EXPECT_THROW(Key("g\ng"), std::invalid_argument);
 }
 
+TEST(TestEquivalent, Semantic)
+{
+    SectionMap a(SectionMapInt{
+        {"Match", {{{"Name", {"eth0"}}}}},
+        {"Network", {{{"DNS", {}}, {"Address", {"10.0.0.1/24"}}}}},
+        {"Route", {{{"Gateway", {"10.0.0.254"}}}, {{"Gateway", {"fe80::1"}}}}},
+    });
+    SectionMap b(SectionMapInt{
+        {"Route", {{{"Gateway", {"fe80::1"}}}, {{"Gateway", {"10.0.0.254"}}}}},
+        {"Network", {{{"Address", {"10.0.0.1/24"}}}}},
+        {"Link", {{}}},
+        {"Match", {{{"Name", {"eth0"}}}}},
+    });
+    EXPECT_TRUE(equivalent(a, b));
+    EXPECT_TRUE(equivalent(SectionMap(), SectionMap()));
+
+    b["Network"][0]["DNS"].emplace_back("10.0.0.2");
+    EXPECT_FALSE(equivalent(a, b));
+    a["Network"][0]["DNS"].emplace_back("10.0.0.2");
+    EXPECT_TRUE(equivalent(a, b));
+
+    // The order of values can matter, like for DNS servers
+    a["Network"][0]["DNS"].emplace_back("10.0.0.3");
+    b["Network"][0]["DNS"].emplace(b["Network"][0]["DNS"].begin(), "10.0.0.3");
+    EXPECT_FALSE(equivalent(a, b));
+}
+
 class TestConfigParser : public stdplus::gtest::TestWithTmp
 {
   public:
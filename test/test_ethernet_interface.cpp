@@ -1,16 +1,24 @@
 #include "config_parser.hpp"
 #include "ipaddress.hpp"
 #include "mock_ethernet_interface.hpp"
+#include "mock_syscall.hpp"
+#include "netlink.hpp"
 #include "test_network_manager.hpp"
 
 #include <net/if.h>
+#include <linux/rtnetlink.h>
 #include <net/if_arp.h>
 
 #include <sdbusplus/bus.hpp>
+#include <sdeventplus/event.hpp>
 #include <stdplus/gtest/tmp.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <chrono>
+#include <filesystem>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -31,7 +39,7 @@ class TestEthernetInterface : public stdplus::gtest::TestWithTmp
     stdplus::Pinned<sdbusplus::bus_t> bus;
     std::filesystem::path confDir;
     TestManager manager;
-    MockEthernetInterface interface;
+    MockEthernetInterface& interface;
     TestEthernetInterface() :
         bus(sdbusplus::bus::new_default()), confDir(CaseTmpDir()),
         manager(bus, "/xyz/openbmc_test/network", confDir),
@@ -39,13 +47,20 @@ class TestEthernetInterface : public stdplus::gtest::TestWithTmp
 
     {}
 
-    static MockEthernetInterface makeInterface(
+    /** @brief Creates the interface under test, owned by the manager like
+     *         the ones it creates itself so queued config writes get flushed
+     */
+    static MockEthernetInterface& makeInterface(
         stdplus::PinnedRef<sdbusplus::bus_t> bus, TestManager& manager)
     {
         AllIntfInfo info{InterfaceInfo{
             .type = ARPHRD_ETHER, .idx = 1, .flags = 0, .name = "test0"}};
-        return {bus, manager, info, "/xyz/openbmc_test/network"sv,
-                config::Parser()};
+        auto intf = std::make_unique<MockEthernetInterface>(
+            bus, manager, info, "/xyz/openbmc_test/network"sv,
+            config::Parser());
+        auto& ret = *intf;
+        manager.interfaces.emplace("test0", std::move(intf));
+        return ret;
     }
 
     auto createIPObject(IP::Protocol addressType, const std::string& ipaddress,
@@ -70,6 +85,24 @@ class TestEthernetInterface : public stdplus::gtest::TestWithTmp
     {
         return interface.EthernetInterfaceIntf::ntpServers();
     }
+
+    void enableApplyNow()
+    {
+        interface.applyNowEnabled = true;
+    }
+
+    /** @brief The types of the rtnetlink messages sent since the last
+     *         mock_clear()
+     */
+    static std::vector<uint16_t> nlRequestTypes()
+    {
+        std::vector<uint16_t> ret;
+        for (std::string_view req : system::mock_nlRequests())
+        {
+            ret.push_back(netlink::extractRtData<nlmsghdr>(req).nlmsg_type);
+        }
+        return ret;
+    }
 };
 
 TEST_F(TestEthernetInterface, Fields)
@@ -151,10 +184,139 @@ TEST_F(TestEthernetInterface, addStaticNameServers)
     ServerList servers = {"9.1.1.1", "9.2.2.2", "9.3.3.3"};
     EXPECT_CALL(manager.mockReload, schedule());
     interface.staticNameServers(servers);
+    manager.flushConfigs();
     config::Parser parser((confDir / "00-bmc-test0.network").native());
     EXPECT_EQ(servers, parser.map.getValueStrings("Network", "DNS"));
 }
 
+TEST_F(TestEthernetInterface, ApplyChanges)
+{
+    createIPObject(IP::Protocol::IPv4, "10.10.10.10", 16);
+
+    // One bad entry rejects the whole transaction
+    EXPECT_CALL(manager.mockReload, schedule()).Times(0);
+    EXPECT_THROW(interface.applyChanges(
+                     {{"DHCP4", false}, {"DHCP6", std::string("no")}}),
+                 InvalidArgument);
+    EXPECT_THROW(interface.applyChanges(
+                     {{"DHCP4", false},
+                      {"StaticAddresses",
+                       std::vector<std::string>{"127.0.0.1/8"}}}),
+                 InvalidArgument);
+    EXPECT_THROW(interface.applyChanges({{"Unknown", false}}),
+                 InvalidArgument);
+    EXPECT_TRUE(interface.dhcp4());
+    EXPECT_THAT(interface.addrs,
+                UnorderedElementsAre(Key("10.10.10.10/16"_sub)));
+    testing::Mock::VerifyAndClearExpectations(&manager.mockReload);
+
+    EXPECT_CALL(manager.mockReload, schedule());
+    ServerList dns = {"9.1.1.1", "9.2.2.2"};
+    interface.applyChanges(
+        {{"DHCP4", false},
+         {"DHCP6", false},
+         {"DefaultGateway", std::string("192.168.1.1")},
+         {"StaticNameServers", dns},
+         {"StaticAddresses",
+          std::vector<std::string>{"192.168.1.2/24", "fd00::2/64"}}});
+    EXPECT_FALSE(interface.dhcp4());
+    EXPECT_FALSE(interface.dhcp6());
+    EXPECT_EQ("192.168.1.1", interface.defaultGateway());
+    EXPECT_THAT(interface.addrs,
+                UnorderedElementsAre(Key("192.168.1.2/24"_sub),
+                                     Key("fd00::2/64"_sub)));
+    EXPECT_EQ(1, manager.flushConfigs());
+    EXPECT_EQ(1, interface.getConfigWrites());
+    config::Parser parser((confDir / "00-bmc-test0.network").native());
+    EXPECT_EQ(dns, parser.map.getValueStrings("Network", "DNS"));
+    EXPECT_THAT(parser.map.getValueStrings("Network", "Address"),
+                UnorderedElementsAre("192.168.1.2/24", "fd00::2/64"));
+    testing::Mock::VerifyAndClearExpectations(&manager.mockReload);
+
+    // Reapplying the same values neither writes nor reloads
+    EXPECT_CALL(manager.mockReload, schedule()).Times(0);
+    interface.applyChanges({{"DHCP4", false}, {"StaticNameServers", dns}});
+    EXPECT_EQ(0, manager.flushConfigs());
+}
+
+TEST_F(TestEthernetInterface, ApplyChangesNow)
+{
+    EXPECT_CALL(manager.mockReload, schedule())
+        .WillRepeatedly(testing::Return());
+    enableApplyNow();
+    createIPObject(IP::Protocol::IPv4, "10.10.10.10", 16);
+    interface.defaultGateway("10.10.0.1");
+
+    // A batch reaches the kernel the same way the single setters do
+    system::mock_clear();
+    interface.applyChanges(
+        {{"DefaultGateway", std::string("192.168.1.1")},
+         {"StaticAddresses", std::vector<std::string>{"192.168.1.2/24"}}});
+    EXPECT_EQ((std::vector<uint16_t>{RTM_DELROUTE, RTM_NEWROUTE, RTM_DELADDR,
+                                     RTM_NEWADDR}),
+              nlRequestTypes());
+}
+
+TEST_F(TestEthernetInterface, DeferredWrites)
+{
+    EXPECT_CALL(manager.mockReload, schedule())
+        .WillRepeatedly(testing::Return());
+    auto file = confDir / "00-bmc-test0.network";
+
+    // Setters only queue the write
+    interface.dhcp4(false);
+    interface.staticNameServers({"9.1.1.1"});
+    interface.defaultGateway("192.168.1.1");
+    EXPECT_EQ(0, interface.getConfigWrites());
+    EXPECT_FALSE(std::filesystem::exists(file));
+
+    EXPECT_EQ(1, manager.flushConfigs());
+    EXPECT_EQ(1, interface.getConfigWrites());
+    config::Parser parser(file.native());
+    EXPECT_EQ((ServerList{"9.1.1.1"}),
+              parser.map.getValueStrings("Network", "DNS"));
+    EXPECT_EQ(0, manager.flushConfigs());
+}
+
+TEST_F(TestEthernetInterface, WritesWaitForReload)
+{
+    EXPECT_CALL(manager.mockReload, schedule())
+        .WillRepeatedly(testing::Return());
+    auto event = sdeventplus::Event::get_default();
+
+    // Each setter arrives in its own dispatch, none of them writes the file
+    interface.dhcp4(false);
+    event.run(std::chrono::microseconds(0));
+    interface.staticNameServers({"9.1.1.1"});
+    event.run(std::chrono::microseconds(0));
+    interface.defaultGateway("192.168.1.1");
+    event.run(std::chrono::microseconds(0));
+    EXPECT_EQ(0, interface.getConfigWrites());
+    EXPECT_EQ(0, manager.getReloadStats().configWrites);
+
+    EXPECT_EQ(1, manager.flushConfigs());
+    EXPECT_EQ(1, interface.getConfigWrites());
+    EXPECT_EQ(1, manager.getReloadStats().configWrites);
+}
+
+TEST_F(TestEthernetInterface, UnchangedWrites)
+{
+    EXPECT_CALL(manager.mockReload, schedule())
+        .WillRepeatedly(testing::Return());
+    EXPECT_TRUE(interface.writeConfigurationFile());
+    EXPECT_FALSE(interface.writeConfigurationFile());
+    EXPECT_EQ(1, interface.getConfigWrites());
+
+    // Changes that cancel out neither write nor reload
+    interface.dhcp4(false);
+    interface.dhcp4(true);
+    manager.reloadCb();
+    EXPECT_EQ(1, interface.getConfigWrites());
+    EXPECT_EQ(1, manager.getReloadStats().unchangedWrites);
+    EXPECT_EQ(1, manager.getReloadStats().avoided);
+    EXPECT_EQ(0, manager.getReloadStats().reloads);
+}
+
 TEST_F(TestEthernetInterface, getDynamicNameServers)
 {
     ServerList servers = {"9.1.1.1", "9.2.2.2", "9.3.3.3"};
@@ -168,6 +330,7 @@ TEST_F(TestEthernetInterface, addStaticNTPServers)
     ServerList servers = {"10.1.1.1", "10.2.2.2", "10.3.3.3"};
     EXPECT_CALL(manager.mockReload, schedule());
     interface.staticNTPServers(servers);
+    manager.flushConfigs();
     config::Parser parser((confDir / "00-bmc-test0.network").native());
     EXPECT_EQ(servers, parser.map.getValueStrings("Network", "NTP"));
 }
@@ -0,0 +1,118 @@
+#include "event_coalescer.hpp"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network::netlink
+{
+
+using stdplus::operator""_sub;
+using stdplus::operator""_ip;
+
+static Event link(bool add, unsigned idx)
+{
+    return Event{add, InterfaceInfo{.type = 1, .idx = idx, .flags = 0}};
+}
+
+static Event addr(bool add, unsigned ifidx, stdplus::SubnetAny ifaddr)
+{
+    return Event{add, AddressInfo{.ifidx = ifidx,
+                                  .ifaddr = ifaddr,
+                                  .scope = 0,
+                                  .flags = 0}};
+}
+
+static std::vector<Event> flush(EventCoalescer& c)
+{
+    std::vector<Event> ret;
+    c.flush([&](const Event& e) { ret.push_back(e); });
+    return ret;
+}
+
+TEST(EventCoalescer, CollapsesToFinalState)
+{
+    EventCoalescer c;
+    c.push(addr(true, 2, "10.0.0.1/24"_sub));
+    c.push(addr(false, 2, "10.0.0.1/24"_sub));
+    c.push(addr(true, 2, "10.0.0.2/24"_sub));
+    c.push(addr(true, 2, "10.0.0.1/24"_sub));
+    c.push(Event{false, DefGwInfo{2, "10.0.0.254"_ip}});
+    EXPECT_EQ(3, c.pending());
+
+    auto ret = flush(c);
+    ASSERT_EQ(3, ret.size());
+    EXPECT_EQ(addr(true, 2, "10.0.0.2/24"_sub).info, ret[0].info);
+    EXPECT_TRUE(ret[1].add);
+    EXPECT_EQ(addr(true, 2, "10.0.0.1/24"_sub).info, ret[1].info);
+    EXPECT_FALSE(ret[2].add);
+    EXPECT_EQ(0, c.pending());
+    EXPECT_EQ(0, flush(c).size());
+
+    EXPECT_EQ(5, c.getStats().pushed);
+    EXPECT_EQ(3, c.getStats().applied);
+    EXPECT_EQ(2, c.getStats().flushes);
+}
+
+TEST(EventCoalescer, LinksFirst)
+{
+    EventCoalescer c;
+    c.push(addr(true, 3, "10.0.0.1/24"_sub));
+    c.push(link(true, 3));
+    c.push(link(false, 4));
+    c.push(link(true, 3));
+
+    auto ret = flush(c);
+    ASSERT_EQ(3, ret.size());
+    EXPECT_EQ(link(false, 4).info, ret[0].info);
+    EXPECT_FALSE(ret[0].add);
+    EXPECT_EQ(link(true, 3).info, ret[1].info);
+    EXPECT_EQ(3, ret[2].ifidx());
+}
+
+TEST(EventCoalescer, LinkRemoveDropsObjects)
+{
+    EventCoalescer c;
+    c.push(link(true, 2));
+    c.push(addr(true, 2, "10.0.0.1/24"_sub));
+    c.push(addr(true, 5, "10.0.0.1/24"_sub));
+    c.push(link(false, 2));
+    // The index is reused by a new link
+    c.push(link(true, 2));
+    c.push(addr(true, 2, "10.0.1.1/24"_sub));
+
+    auto ret = flush(c);
+    ASSERT_EQ(4, ret.size());
+    EXPECT_FALSE(ret[0].add);
+    EXPECT_EQ(2, ret[0].ifidx());
+    EXPECT_TRUE(ret[1].add);
+    EXPECT_EQ(2, ret[1].ifidx());
+    EXPECT_EQ(addr(true, 5, "10.0.0.1/24"_sub).info, ret[2].info);
+    EXPECT_EQ(addr(true, 2, "10.0.1.1/24"_sub).info, ret[3].info);
+}
+
+TEST(EventCoalescer, FlappingStaysBounded)
+{
+    EventCoalescer c;
+    c.push(addr(true, 2, "10.0.0.1/24"_sub));
+    c.push(addr(true, 3, "10.0.0.1/24"_sub));
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        c.push(addr(i % 2 == 0, 2, "10.0.0.2/24"_sub));
+    }
+    c.push(addr(true, 4, "10.0.0.1/24"_sub));
+    EXPECT_EQ(4, c.pending());
+    EXPECT_GE(40, c.buffered());
+
+    // Compacting keeps the order of the last updates
+    auto ret = flush(c);
+    ASSERT_EQ(4, ret.size());
+    EXPECT_EQ(addr(true, 2, "10.0.0.1/24"_sub).info, ret[0].info);
+    EXPECT_EQ(addr(true, 3, "10.0.0.1/24"_sub).info, ret[1].info);
+    EXPECT_FALSE(ret[2].add);
+    EXPECT_EQ(addr(false, 2, "10.0.0.2/24"_sub).info, ret[2].info);
+    EXPECT_EQ(addr(true, 4, "10.0.0.1/24"_sub).info, ret[3].info);
+    EXPECT_EQ(1003, c.getStats().pushed);
+}
+
+} // namespace phosphor::network::netlink
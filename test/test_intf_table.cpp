@@ -0,0 +1,63 @@
+#include "intf_table.hpp"
+
+#include <net/if_arp.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+TEST(IntfTable, Slots)
+{
+    IntfTable t;
+    EXPECT_EQ(nullptr, t.find(3));
+    EXPECT_EQ(nullptr, t.info(3));
+    EXPECT_FALSE(t.ignored(3));
+
+    t.slot(3).info = std::make_unique<AllIntfInfo>(AllIntfInfo{
+        .intf = {.type = ARPHRD_ETHER, .idx = 3, .flags = 0, .name = "eth0"}});
+    auto info = t.info(3);
+    ASSERT_NE(nullptr, info);
+
+    // Growing the table keeps the kernel state in place
+    t.slot(1000).enabled = true;
+    EXPECT_EQ(info, t.info(3));
+    EXPECT_EQ(nullptr, t.intf(3));
+    EXPECT_EQ(nullptr, t.info(2));
+
+    // Explicitly numbered links far past the dense range stay sparse
+    t.slot(IntfTable::denseMax + 5).enabled = false;
+    EXPECT_NE(nullptr, t.find(IntfTable::denseMax + 5));
+    EXPECT_EQ(nullptr, t.find(IntfTable::denseMax + 4));
+
+    std::vector<unsigned> used;
+    t.forEach([&](unsigned ifidx, IntfTable::Slot&) { used.push_back(ifidx); });
+    EXPECT_EQ((std::vector<unsigned>{3, 1000, IntfTable::denseMax + 5}), used);
+}
+
+TEST(IntfTable, Ignored)
+{
+    IntfTable t;
+    auto gen = t.getIgnoredGeneration();
+    t.setIgnored(7, false);
+    EXPECT_EQ(gen, t.getIgnoredGeneration());
+
+    t.setIgnored(IntfTable::denseMax + 1, true);
+    t.setIgnored(7, true);
+    t.setIgnored(7, true);
+    EXPECT_TRUE(t.ignored(7));
+    EXPECT_TRUE(t.ignored(IntfTable::denseMax + 1));
+    EXPECT_EQ(gen + 2, t.getIgnoredGeneration());
+    EXPECT_EQ((std::vector<unsigned>{7, IntfTable::denseMax + 1}),
+              t.ignoredIntfs());
+
+    t.setIgnored(7, false);
+    EXPECT_FALSE(t.ignored(7));
+    EXPECT_EQ(gen + 3, t.getIgnoredGeneration());
+    EXPECT_EQ((std::vector<unsigned>{IntfTable::denseMax + 1}),
+              t.ignoredIntfs());
+}
+
+} // namespace phosphor::network
@@ -0,0 +1,100 @@
+#include "link_stats.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+using std::literals::chrono_literals::operator""s;
+
+class LinkStatsTest : public testing::Test
+{
+  protected:
+    LinkStatsTable table{10s};
+    std::chrono::steady_clock::time_point start{};
+
+    LinkSample sample(std::chrono::seconds at, uint64_t rx, uint64_t tx,
+                      uint64_t rxErr = 0)
+    {
+        return LinkSample{.time = start + at,
+                          .rxBytes = rx,
+                          .txBytes = tx,
+                          .rxPackets = 0,
+                          .txPackets = 0,
+                          .rxErrors = rxErr,
+                          .txErrors = 0,
+                          .rxDropped = 0,
+                          .txDropped = 0};
+    }
+};
+
+TEST_F(LinkStatsTest, Rates)
+{
+    table.record(1, sample(0s, 0, 0));
+    EXPECT_FALSE(table.get(1)->primed);
+    EXPECT_EQ(0, table.get(1)->rates.rxBytes);
+
+    // The first interval sets the rates outright
+    table.record(1, sample(10s, 10000, 5000, 10));
+    auto h = table.get(1);
+    ASSERT_NE(nullptr, h);
+    EXPECT_TRUE(h->primed);
+    EXPECT_DOUBLE_EQ(1000, h->rates.rxBytes);
+    EXPECT_DOUBLE_EQ(500, h->rates.txBytes);
+    EXPECT_DOUBLE_EQ(1, h->rates.rxErrors);
+
+    // Later ones move it by 1 - e^-1 after one time constant
+    table.record(1, sample(20s, 10000, 5000, 10));
+    EXPECT_NEAR(1000 * std::exp(-1), h->rates.rxBytes, 1e-6);
+    EXPECT_NEAR(500 * std::exp(-1), h->rates.txBytes, 1e-6);
+
+    // A counter reset starts over
+    table.record(1, sample(30s, 100, 5000));
+    EXPECT_FALSE(h->primed);
+    EXPECT_EQ(0, h->rates.rxBytes);
+    table.record(1, sample(40s, 1100, 5000));
+    EXPECT_DOUBLE_EQ(100, h->rates.rxBytes);
+    EXPECT_DOUBLE_EQ(0, h->rates.txBytes);
+}
+
+TEST_F(LinkStatsTest, History)
+{
+    for (unsigned i = 0; i < LinkStatsTable::historyLen + 5; ++i)
+    {
+        table.record(2, sample(std::chrono::seconds(i), i, 0));
+    }
+    auto h = table.get(2);
+    ASSERT_NE(nullptr, h);
+    EXPECT_EQ(LinkStatsTable::historyLen, h->count);
+    EXPECT_EQ(LinkStatsTable::historyLen + 4, h->latest().rxBytes);
+
+    std::vector<uint64_t> rx;
+    h->forEach([&](const LinkSample& s) { rx.push_back(s.rxBytes); });
+    ASSERT_EQ(LinkStatsTable::historyLen, rx.size());
+    for (size_t i = 0; i < rx.size(); ++i)
+    {
+        EXPECT_EQ(i + 5, rx[i]);
+    }
+}
+
+TEST_F(LinkStatsTest, Prune)
+{
+    table.record(1, sample(0s, 0, 0));
+    table.record(2, sample(0s, 0, 0));
+    table.prune();
+    EXPECT_EQ(2, table.size());
+
+    table.record(2, sample(1s, 0, 0));
+    table.prune();
+    EXPECT_EQ(nullptr, table.get(1));
+    EXPECT_NE(nullptr, table.get(2));
+
+    table.prune();
+    EXPECT_EQ(0, table.size());
+}
+
+} // namespace phosphor::network
@@ -0,0 +1,93 @@
+#include "lldp_control.hpp"
+
+#include <stdplus/gtest/tmp.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+class TestLLDPControl : public stdplus::gtest::TestWithTmp
+{
+  protected:
+    std::filesystem::path conf = CaseTmpDir() + "/lldpd.conf";
+    std::vector<std::vector<std::string>> commands;
+    size_t restarts = 0;
+    bool failCommands = false;
+    int exitStatus = 0;
+    LLDPControl lldp{
+        conf,
+        [this](const std::vector<std::string>& args) {
+            if (failCommands)
+            {
+                throw std::runtime_error("lldpcli failed");
+            }
+            commands.push_back(args);
+            return exitStatus;
+        },
+        [this]() { restarts++; }};
+
+    std::string readConf()
+    {
+        std::ifstream file(conf);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+};
+
+TEST_F(TestLLDPControl, Incremental)
+{
+    std::map<std::string, bool> ports{{"eth0", true}, {"eth1", false}};
+    // Not even the first change restarts lldpd
+    lldp.apply(ports, "eth0");
+    EXPECT_EQ(0, restarts);
+
+    ports["eth1"] = true;
+    lldp.apply(ports, "eth1");
+    ports["eth0"] = false;
+    lldp.apply(ports, "eth0");
+    EXPECT_EQ(0, restarts);
+    EXPECT_EQ((std::vector<std::vector<std::string>>{
+                  {"configure", "ports", "eth0", "lldp", "status", "tx-only"},
+                  {"configure", "ports", "eth1", "lldp", "status", "tx-only"},
+                  {"configure", "ports", "eth0", "lldp", "status", "disabled"},
+              }),
+              commands);
+
+    EXPECT_EQ("configure system description BMC\n"
+              "configure system ip management pattern eth*\n"
+              "configure ports eth0 lldp status disabled\n"
+              "configure ports eth1 lldp status tx-only\n",
+              readConf());
+}
+
+TEST_F(TestLLDPControl, Fallback)
+{
+    std::map<std::string, bool> ports{{"eth0", true}};
+    lldp.apply(ports, "eth0");
+
+    // A change lldpcli could not apply is picked up by a restart
+    failCommands = true;
+    ports["eth0"] = false;
+    lldp.apply(ports, "eth0");
+    EXPECT_EQ(1, restarts);
+    EXPECT_EQ("configure system description BMC\n"
+              "configure system ip management pattern eth*\n"
+              "configure ports eth0 lldp status disabled\n",
+              readConf());
+
+    // So is one lldpcli rejected, e.g. with lldpd not running
+    failCommands = false;
+    exitStatus = 1;
+    ports["eth0"] = true;
+    lldp.apply(ports, "eth0");
+    EXPECT_EQ(2, restarts);
+    EXPECT_EQ(2, commands.size());
+}
+
+} // namespace phosphor::network
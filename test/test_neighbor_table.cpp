@@ -0,0 +1,92 @@
+#include "neighbor_table.hpp"
+
+#include <linux/neighbour.h>
+#include <net/ethernet.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+using stdplus::operator""_ip;
+
+static NeighborInfo neigh(unsigned ifidx, stdplus::InAnyAddr addr,
+                          uint16_t state = NUD_REACHABLE, uint8_t mac = 1)
+{
+    return NeighborInfo{.ifidx = ifidx,
+                        .state = state,
+                        .addr = addr,
+                        .mac = stdplus::EtherAddr(
+                            ether_addr{{0x02, 0, 0, 0, 0, mac}})};
+}
+
+static std::vector<NeighborInfo> list(const NeighborTable& t,
+                                      unsigned ifidx = 0)
+{
+    std::vector<NeighborInfo> ret;
+    t.forEach(ifidx, [&](const NeighborInfo& info) { ret.push_back(info); });
+    return ret;
+}
+
+TEST(NeighborTable, Update)
+{
+    NeighborTable t;
+    size_t notified = 0;
+    t.setNotify([&]() { notified++; });
+
+    EXPECT_TRUE(t.update(neigh(2, "192.168.0.2"_ip)));
+    EXPECT_TRUE(t.update(neigh(1, "fe80::1"_ip)));
+    EXPECT_TRUE(t.update(neigh(2, "192.168.0.1"_ip)));
+    EXPECT_FALSE(t.update(neigh(2, "192.168.0.1"_ip)));
+    EXPECT_TRUE(t.update(neigh(2, "192.168.0.1"_ip, NUD_STALE)));
+    EXPECT_EQ(3, t.size());
+    EXPECT_EQ(4, t.getGeneration());
+    EXPECT_EQ(4, notified);
+
+    EXPECT_EQ((std::vector{neigh(1, "fe80::1"_ip),
+                           neigh(2, "192.168.0.1"_ip, NUD_STALE),
+                           neigh(2, "192.168.0.2"_ip)}),
+              list(t));
+    EXPECT_EQ((std::vector{neigh(1, "fe80::1"_ip)}), list(t, 1));
+    EXPECT_TRUE(list(t, 3).empty());
+
+    // Incomplete entries have no link layer address yet
+    NeighborInfo incomplete{.ifidx = 3,
+                            .state = NUD_INCOMPLETE,
+                            .addr = "10.0.0.1"_ip,
+                            .mac = std::nullopt};
+    EXPECT_TRUE(t.update(incomplete));
+    EXPECT_EQ((std::vector{incomplete}), list(t, 3));
+}
+
+TEST(NeighborTable, Remove)
+{
+    NeighborTable t;
+    t.update(neigh(1, "10.0.0.1"_ip));
+    t.update(neigh(2, "10.0.0.1"_ip));
+    t.update(neigh(2, "10.0.0.2"_ip));
+    t.update(neigh(3, "10.0.0.1"_ip));
+
+    EXPECT_TRUE(t.remove(neigh(1, "10.0.0.1"_ip)));
+    EXPECT_FALSE(t.remove(neigh(1, "10.0.0.1"_ip)));
+    EXPECT_FALSE(t.remove(neigh(2, "10.0.0.3"_ip)));
+    EXPECT_EQ(2, t.removeIntf(2));
+    EXPECT_EQ(0, t.removeIntf(2));
+    EXPECT_EQ((std::vector{neigh(3, "10.0.0.1"_ip)}), list(t));
+
+    auto gen = t.getGeneration();
+    NeighborTable other;
+    other.update(neigh(3, "10.0.0.1"_ip));
+    t.assign(std::move(other));
+    EXPECT_EQ(gen, t.getGeneration());
+
+    other = NeighborTable();
+    other.update(neigh(4, "10.0.0.4"_ip));
+    t.assign(std::move(other));
+    EXPECT_EQ(gen + 1, t.getGeneration());
+    EXPECT_EQ((std::vector{neigh(4, "10.0.0.4"_ip)}), list(t));
+}
+
+} // namespace phosphor::network
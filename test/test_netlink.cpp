@@ -1,16 +1,26 @@
 #include "mock_syscall.hpp"
 #include "netlink.hpp"
+#include "netlink_async.hpp"
+#include "netlink_stats.hpp"
 #include "util.hpp"
 
+#include <linux/neighbour.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <sys/socket.h>
 
+#include <sdeventplus/event.hpp>
+#include <stdplus/fd/managed.hpp>
 #include <stdplus/raw.hpp>
 
+#include <array>
+#include <cerrno>
+#include <chrono>
 #include <cstring>
 #include <format>
 #include <stdexcept>
 #include <string_view>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -137,6 +147,29 @@ TEST(ExtractMsgs, ErrMsg)
     EXPECT_TRUE(done);
 }
 
+TEST(ExtractMsgs, KernelErrMsg)
+{
+    nlmsgerr err{};
+    err.error = -EEXIST;
+    nlmsghdr hdr{};
+    constexpr size_t len = NLMSG_LENGTH(sizeof(err));
+    hdr.nlmsg_len = len;
+    hdr.nlmsg_type = NLMSG_ERROR;
+    char buf[NLMSG_ALIGN(len)];
+    std::memcpy(buf, &hdr, sizeof(hdr));
+    std::memcpy(NLMSG_DATA(buf), &err, sizeof(err));
+    std::string_view data(reinterpret_cast<char*>(&buf), sizeof(buf));
+
+    int errOut = 0;
+    auto cb = [&](const nlmsghdr&, std::string_view data) {
+        errOut = stdplus::raw::extract<nlmsgerr>(data).error;
+    };
+    bool done = true;
+    processMsg(data, done, cb);
+    EXPECT_EQ(-EEXIST, errOut);
+    EXPECT_TRUE(done);
+}
+
 TEST(ExtractMsgs, DoneNoMulti)
 {
     nlmsghdr hdr{};
@@ -292,6 +325,135 @@ TEST(ExtractRtAttr, SomeData)
     EXPECT_EQ(0, memcmp(&nextbuf, data.data(), sizeof(nextbuf)));
 }
 
+TEST(RtAttrs, Index)
+{
+    auto append = [](std::string& buf, unsigned short type,
+                     std::string_view data) {
+        rtattr rta{};
+        rta.rta_len = RTA_LENGTH(data.size());
+        rta.rta_type = type;
+        auto begin = buf.size();
+        buf.append(RTA_SPACE(data.size()), '\0');
+        memcpy(buf.data() + begin, &rta, sizeof(rta));
+        memcpy(buf.data() + begin + RTA_LENGTH(0), data.data(), data.size());
+    };
+    std::string buf;
+    append(buf, 1, "abcd");
+    append(buf, 3, "old");
+    append(buf, 3, "new");
+    append(buf, 9, "ignored");
+
+    RtAttrs<4> attrs(buf);
+    EXPECT_EQ("abcd", attrs[1]);
+    EXPECT_FALSE(attrs.contains(2));
+    EXPECT_EQ(nullptr, attrs[2].data());
+    EXPECT_EQ("new", attrs[3]);
+    EXPECT_EQ(std::nullopt, attrs.get<uint32_t>(4));
+    EXPECT_EQ(stdplus::raw::copyFrom<uint32_t>(std::string_view("abcd")),
+              attrs.get<uint32_t>(1));
+
+    buf.resize(buf.size() - 2);
+    EXPECT_THROW(RtAttrs<4>{buf}, std::runtime_error);
+}
+
+TEST(MsgBuilder, Layout)
+{
+    MsgBuilder b;
+    ifaddrmsg ifa{};
+    ifa.ifa_family = AF_INET;
+    ifa.ifa_prefixlen = 24;
+    ifa.ifa_index = 2;
+    const std::array<uint8_t, 4> addr = {192, 168, 1, 1};
+    b.begin(RTM_NEWADDR, NLM_F_CREATE, ifa).attr(IFA_LOCAL, addr);
+    b.begin(RTM_NEWLINK, 0, ifinfomsg{})
+        .attr(IFLA_IFNAME, std::string_view("eth0", 5))
+        .beginNested(IFLA_LINKINFO)
+        .attr(IFLA_INFO_KIND, std::string_view("vlan", 5))
+        .beginNested(IFLA_INFO_DATA)
+        .attr(IFLA_VLAN_ID, uint16_t{7})
+        .endNested()
+        .endNested();
+    EXPECT_EQ(2, b.count());
+    auto buf = b.finish();
+    std::string_view msgs(buf.data(), buf.size());
+
+    size_t seen = 0;
+    auto cb = [&](const nlmsghdr& hdr, std::string_view data) {
+        EXPECT_EQ(NLM_F_REQUEST | NLM_F_ACK, hdr.nlmsg_flags & 0xf);
+        if (seen++ == 0)
+        {
+            EXPECT_EQ(RTM_NEWADDR, hdr.nlmsg_type);
+            auto [msg, attrs] = parseRtm<ifaddrmsg>(data);
+            EXPECT_EQ(2, msg.ifa_index);
+            EXPECT_EQ(addr, (attrs.get<std::array<uint8_t, 4>>(IFA_LOCAL)));
+        }
+        else
+        {
+            EXPECT_EQ(RTM_NEWLINK, hdr.nlmsg_type);
+            auto [msg, attrs] = parseRtm<ifinfomsg>(data);
+            EXPECT_EQ(std::string_view("eth0", 5), attrs[IFLA_IFNAME]);
+            RtAttrs<IFLA_INFO_MAX> info(attrs[IFLA_LINKINFO]);
+            EXPECT_EQ(std::string_view("vlan", 5), info[IFLA_INFO_KIND]);
+            RtAttrs<IFLA_VLAN_MAX> vlan(info[IFLA_INFO_DATA]);
+            EXPECT_EQ(7, vlan.get<uint16_t>(IFLA_VLAN_ID));
+        }
+        // Every length is padded to the netlink alignment
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(data.data()) % NLMSG_ALIGNTO);
+    };
+    bool done = true;
+    while (!msgs.empty())
+    {
+        detail::processMsg(msgs, done, cb);
+    }
+    EXPECT_EQ(2, seen);
+
+    b.clear();
+    EXPECT_EQ(0, b.count());
+    EXPECT_TRUE(b.finish().empty());
+    EXPECT_THROW(b.attr(IFA_LOCAL, addr), std::runtime_error);
+    b.begin(RTM_NEWLINK, 0, ifinfomsg{}).beginNested(IFLA_LINKINFO);
+    EXPECT_THROW(b.finish(), std::runtime_error);
+}
+
+TEST(MsgBuilder, BatchRequest)
+{
+    system::mock_clear();
+    MsgBuilder b;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        ndmsg ndm{};
+        ndm.ndm_family = AF_INET;
+        ndm.ndm_ifindex = i + 1;
+        ndm.ndm_state = NUD_PERMANENT;
+        b.begin(RTM_NEWNEIGH, NLM_F_CREATE | NLM_F_REPLACE, ndm)
+            .attr(NDA_DST, std::array<uint8_t, 4>{10, 0, 0, 1})
+            .attr(NDA_LLADDR, std::array<uint8_t, 6>{2, 0, 0, 0, 0, 1});
+    }
+
+    size_t cbCalls = 0;
+    auto cb = [&](const nlmsghdr&, std::string_view) { cbCalls++; };
+    Request req(NETLINK_ROUTE, b);
+    EXPECT_EQ(3, req.receive(cb));
+    EXPECT_EQ(0, cbCalls);
+
+    // One datagram carried all three messages under a single sequence number
+    const auto& sent = system::mock_nlRequests();
+    ASSERT_EQ(3, sent.size());
+    for (unsigned i = 0; i < sent.size(); ++i)
+    {
+        std::string_view data(sent[i]);
+        auto hdr = stdplus::raw::extract<nlmsghdr>(data);
+        EXPECT_EQ(RTM_NEWNEIGH, hdr.nlmsg_type);
+        EXPECT_EQ(stdplus::raw::copyFrom<nlmsghdr>(sent[0]).nlmsg_seq,
+                  hdr.nlmsg_seq);
+        data = std::string_view(sent[i]).substr(NLMSG_HDRLEN);
+        auto [ndm, attrs] = parseRtm<ndmsg>(data);
+        EXPECT_EQ(i + 1, ndm.ndm_ifindex);
+        EXPECT_EQ(4, attrs[NDA_DST].size());
+        EXPECT_EQ(6, attrs[NDA_LLADDR].size());
+    }
+}
+
 class PerformRequest : public testing::Test
 {
   public:
@@ -335,6 +497,274 @@ TEST_F(PerformRequest, MultiMsg)
     doLinkDump(1000);
 }
 
+TEST_F(PerformRequest, ReusesSocket)
+{
+    doLinkDump(1);
+    const auto opened = system::mock_socketsOpened();
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        doLinkDump(2);
+    }
+    EXPECT_EQ(opened, system::mock_socketsOpened());
+}
+
+TEST_F(PerformRequest, AbandonedRequest)
+{
+    system::mock_clear();
+    system::mock_addIF(
+        InterfaceInfo{.type = 1u, .idx = 1u, .flags = 0, .name = "eth0"});
+    auto cb = [&](const nlmsghdr&, std::string_view) {
+        throw std::runtime_error("Abandon request");
+    };
+    EXPECT_THROW(netlink::performRequest(NETLINK_ROUTE, RTM_GETLINK,
+                                         NLM_F_DUMP, ifinfomsg{}, cb),
+                 std::runtime_error);
+
+    // The unread remainder of the dump must not leak into later requests
+    doLinkDump(3);
+}
+
+TEST_F(PerformRequest, Pipelined)
+{
+    system::mock_clear();
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        system::mock_addIF(InterfaceInfo{.type = 1u,
+                                         .idx = i + 1u,
+                                         .flags = 0,
+                                         .name = std::format("eth{}", i)});
+    }
+
+    Request first(NETLINK_ROUTE, RTM_GETLINK, NLM_F_DUMP, ifinfomsg{});
+    Request second(NETLINK_ROUTE, RTM_GETLINK, NLM_F_DUMP, ifinfomsg{});
+    size_t cbCalls = 0;
+    auto cb = [&](const nlmsghdr&, std::string_view) { cbCalls++; };
+    second.receive(cb);
+    EXPECT_EQ(3, cbCalls);
+    first.receive(cb);
+    EXPECT_EQ(6, cbCalls);
+}
+
+TEST(BatchReceiver, DrainsDump)
+{
+    system::mock_clear();
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        system::mock_addIF(InterfaceInfo{.type = 1u,
+                                         .idx = i + 1u,
+                                         .flags = 0,
+                                         .name = std::format("eth{}", i)});
+    }
+
+    stdplus::ManagedFd fd(socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK,
+                                 NETLINK_ROUTE));
+    struct
+    {
+        nlmsghdr hdr;
+        ifinfomsg msg;
+    } req{};
+    req.hdr.nlmsg_len = sizeof(req);
+    req.hdr.nlmsg_type = RTM_GETLINK;
+    req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | NLM_F_DUMP;
+    sockaddr_nl dst{};
+    dst.nl_family = AF_NETLINK;
+    iovec iov{.iov_base = &req, .iov_len = sizeof(req)};
+    msghdr hdr{};
+    hdr.msg_name = &dst;
+    hdr.msg_namelen = sizeof(dst);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    ASSERT_LT(0, sendmsg(fd.get(), &hdr, 0));
+
+    BatchReceiver rx(4);
+    size_t cbCalls = 0;
+    auto cb = [&](const nlmsghdr&, std::string_view) { cbCalls++; };
+    rx.receive(fd.get(), cb);
+    EXPECT_EQ(1000, cbCalls);
+
+    const auto& stats = rx.getStats();
+    EXPECT_EQ(0, stats.truncated);
+    EXPECT_LT(stats.syscalls, stats.datagrams);
+    EXPECT_LT(1.0, stats.msgsPerSyscall());
+
+    // Nothing left, a single probe finds the socket empty
+    EXPECT_EQ(0, rx.receive(fd.get(), cb));
+    EXPECT_EQ(stats.datagrams, rx.getStats().datagrams);
+}
+
+TEST(BatchReceiver, TruncatedOverrun)
+{
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds));
+    stdplus::ManagedFd rd(std::move(fds[0])), wr(std::move(fds[1]));
+
+    // The head datagram fits, the one queued behind it in the same batch
+    // is larger than the buffers
+    struct
+    {
+        nlmsghdr hdr;
+        ifinfomsg msg;
+    } small{};
+    small.hdr.nlmsg_len = sizeof(small);
+    small.hdr.nlmsg_type = RTM_NEWLINK;
+    ASSERT_EQ(sizeof(small), send(wr.get(), &small, sizeof(small), 0));
+    BatchReceiver rx(4);
+    std::vector<char> big(rx.getBufSize() * 2);
+    ASSERT_EQ(big.size(), send(wr.get(), big.data(), big.size(), 0));
+
+    size_t cbCalls = 0;
+    auto cb = [&](const nlmsghdr&, std::string_view) { cbCalls++; };
+    EXPECT_EQ(1, rx.receive(rd.get(), cb));
+    EXPECT_EQ(1, cbCalls);
+    EXPECT_EQ(1, rx.getStats().truncated);
+
+    // The lost events must trigger a resync
+    EXPECT_TRUE(rx.takeOverrun());
+    EXPECT_FALSE(rx.takeOverrun());
+    EXPECT_LE(big.size(), rx.getBufSize());
+}
+
+/** @brief Builds an address event, as multicast by the kernel */
+static std::string addrEvent(unsigned ifidx)
+{
+    MsgBuilder msg;
+    msg.begin(RTM_NEWADDR, 0, ifaddrmsg{.ifa_index = ifidx});
+    auto buf = msg.finish();
+    auto& hdr = *reinterpret_cast<nlmsghdr*>(buf.data());
+    hdr.nlmsg_flags = 0;
+    hdr.nlmsg_seq = 0;
+    hdr.nlmsg_pid = 0;
+    return std::string(buf.data(), buf.size());
+}
+
+TEST(DumpInline, LinkDump)
+{
+    system::mock_clear();
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        system::mock_addIF(InterfaceInfo{.type = 1u,
+                                         .idx = i + 1u,
+                                         .flags = 0,
+                                         .name = std::format("eth{}", i)});
+    }
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        system::mock_addEvent(addrEvent(2001 + i));
+    }
+    system::mock_addEvent(addrEvent(3001), /*afterDump=*/true);
+    system::mock_addEvent(addrEvent(3002), /*afterDump=*/true);
+
+    // Unbound, so the socket shares the port of the mocked kernel replies,
+    // the events are told apart by their sequence number
+    stdplus::ManagedFd fd(socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK,
+                                 NETLINK_ROUTE));
+    MsgBuilder msg;
+    msg.begin(RTM_GETLINK, NLM_F_DUMP, ifinfomsg{});
+    // Interface and event indexes in the order they were handed over
+    std::vector<unsigned> seen;
+    auto ret = dumpInline(fd.get(), msg,
+                          [&](const nlmsghdr& hdr, std::string_view data) {
+        if (hdr.nlmsg_type == RTM_NEWLINK)
+        {
+            seen.push_back(extractRtData<ifinfomsg>(data).ifi_index);
+        }
+        else
+        {
+            EXPECT_EQ(RTM_NEWADDR, hdr.nlmsg_type);
+            seen.push_back(extractRtData<ifaddrmsg>(data).ifa_index);
+        }
+    });
+    EXPECT_EQ(1000, ret.replies);
+    EXPECT_EQ(3, ret.events);
+    EXPECT_FALSE(ret.interrupted);
+    EXPECT_FALSE(ret.overrun);
+
+    // Each event sits between two reply datagrams, in the order queued
+    ASSERT_EQ(1003, seen.size());
+    std::vector<size_t> eventPos;
+    for (size_t i = 0; i < seen.size(); ++i)
+    {
+        if (seen[i] > 2000)
+        {
+            EXPECT_EQ(2001 + eventPos.size(), seen[i]);
+            eventPos.push_back(i);
+        }
+    }
+    ASSERT_EQ(3, eventPos.size());
+    EXPECT_LT(0, eventPos.front());
+    EXPECT_GT(seen.size() - 1, eventPos.back());
+    EXPECT_LT(eventPos[0], eventPos[1] - 1);
+    EXPECT_LT(eventPos[1], eventPos[2] - 1);
+
+    // Events queued after NLMSG_DONE are left for the event handler
+    std::vector<unsigned> after;
+    BatchReceiver rx;
+    EXPECT_EQ(2, rx.receive(fd.get(),
+                            [&](const nlmsghdr& hdr, std::string_view data) {
+        EXPECT_EQ(RTM_NEWADDR, hdr.nlmsg_type);
+        after.push_back(extractRtData<ifaddrmsg>(data).ifa_index);
+    }));
+    EXPECT_EQ((std::vector<unsigned>{3001, 3002}), after);
+}
+
+TEST(AsyncRequester, Timeout)
+{
+    system::mock_clear();
+    system::mock_addIF(
+        InterfaceInfo{.type = 1u, .idx = 1u, .flags = 0, .name = "eth0"});
+
+    auto event = sdeventplus::Event::get_new();
+    AsyncRequester req(event, NETLINK_ROUTE);
+    size_t msgs = 0;
+    int result = -1;
+    req.request(
+        RTM_GETLINK, NLM_F_DUMP, ifinfomsg{}, std::chrono::milliseconds(10),
+        [&](const nlmsghdr&, std::string_view) { msgs++; },
+        [&](int err) {
+            result = err;
+            event.exit(0);
+        });
+    EXPECT_EQ(1, req.pending());
+
+    // The mock never wakes the socket up, so the deadline has to fire
+    event.loop();
+    EXPECT_EQ(ETIMEDOUT, result);
+    EXPECT_EQ(0, msgs);
+    EXPECT_EQ(0, req.pending());
+}
+
+TEST(MessageStats, Counters)
+{
+    using namespace std::chrono_literals;
+    EXPECT_EQ(0, MessageStats::bucket(0ns));
+    EXPECT_EQ(0, MessageStats::bucket(1023ns));
+    EXPECT_EQ(1, MessageStats::bucket(1024ns));
+    EXPECT_EQ(4, MessageStats::bucket(10us));
+    EXPECT_EQ(MessageStats::buckets - 1, MessageStats::bucket(1s));
+
+    MessageStats stats;
+    stats.received(RTM_NEWADDR, 64);
+    stats.received(RTM_NEWADDR, 72);
+    stats.failed(RTM_NEWADDR);
+    stats.applied(RTM_NEWADDR, 3us);
+    stats.received(NLMSG_DONE, 20);
+    EXPECT_EQ(nullptr, stats.get(NLMSG_DONE));
+
+    const auto& c = *stats.get(RTM_NEWADDR);
+    EXPECT_EQ(2, c.messages);
+    EXPECT_EQ(136, c.bytes);
+    EXPECT_EQ(1, c.errors);
+    EXPECT_EQ(1, c.applied);
+    EXPECT_EQ(3000, c.appliedNs);
+    EXPECT_EQ(1, c.latency[2]);
+    EXPECT_EQ(0, stats.get(RTM_DELADDR)->messages);
+    EXPECT_EQ("RTM_NEWADDR", MessageStats::typeName(RTM_NEWADDR));
+
+    stats.reset();
+    EXPECT_EQ(0, c.messages);
+    EXPECT_EQ(0, c.latency[2]);
+}
+
 } // namespace netlink
 } // namespace network
 } // namespace phosphor
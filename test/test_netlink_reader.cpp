@@ -0,0 +1,174 @@
+#include "netlink_reader.hpp"
+
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <stdplus/fd/managed.hpp>
+
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+TEST(SpscRing, Bounded)
+{
+    SpscRing<int> ring(3);
+    EXPECT_EQ(4, ring.capacity());
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.push(int{i}));
+    }
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(4, ring.size());
+    EXPECT_EQ(0, ring.pop());
+    EXPECT_TRUE(ring.push(4));
+    for (int i = 1; i < 5; ++i)
+    {
+        EXPECT_EQ(i, ring.pop());
+    }
+    EXPECT_EQ(std::nullopt, ring.pop());
+}
+
+TEST(SpscRing, Threads)
+{
+    constexpr int n = 10000;
+    SpscRing<int> ring(64);
+    std::thread producer([&] {
+        for (int i = 0; i < n;)
+        {
+            if (ring.push(int{i}))
+            {
+                ++i;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (int expected = 0; expected < n;)
+    {
+        if (auto v = ring.pop())
+        {
+            ASSERT_EQ(expected++, *v);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+namespace netlink
+{
+
+class EventReaderTest : public testing::Test
+{
+  protected:
+    stdplus::ManagedFd rx, tx;
+
+    EventReaderTest()
+    {
+        // The reader only needs datagrams, which a socketpair provides
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds) < 0)
+        {
+            throw std::system_error(errno, std::generic_category());
+        }
+        rx = stdplus::ManagedFd(std::move(fds[0]));
+        tx = stdplus::ManagedFd(std::move(fds[1]));
+    }
+
+    template <typename T>
+    void sendMsg(uint16_t type, const T& body)
+    {
+        std::string buf(NLMSG_SPACE(sizeof(body)), '\0');
+        nlmsghdr hdr{};
+        hdr.nlmsg_len = NLMSG_LENGTH(sizeof(body));
+        hdr.nlmsg_type = type;
+        std::memcpy(buf.data(), &hdr, sizeof(hdr));
+        std::memcpy(buf.data() + NLMSG_HDRLEN, &body, sizeof(body));
+        ASSERT_EQ(buf.size(), send(tx.get(), buf.data(), buf.size(), 0));
+    }
+
+    static std::vector<EventReader::Item> wait(EventReader& reader,
+                                               size_t count)
+    {
+        std::vector<EventReader::Item> ret;
+        while (ret.size() < count)
+        {
+            pollfd pfd{};
+            pfd.fd = reader.getWakeFd();
+            pfd.events = POLLIN;
+            if (poll(&pfd, 1, 1000) <= 0)
+            {
+                break;
+            }
+            reader.drain([&](EventReader::Item&& item) {
+                ret.push_back(std::move(item));
+            });
+        }
+        return ret;
+    }
+};
+
+TEST_F(EventReaderTest, Decodes)
+{
+    EventReader reader(rx.get(), 16);
+
+    ndmsg ndm{};
+    ndm.ndm_ifindex = 2;
+    sendMsg(RTM_NEWNEIGH, ndm);
+    // Addresses without IFA_ADDRESS are malformed
+    ifaddrmsg ifa{};
+    ifa.ifa_index = 3;
+    sendMsg(RTM_DELADDR, ifa);
+
+    auto items = wait(reader, 2);
+    ASSERT_EQ(2, items.size());
+    auto& e = std::get<Event>(items[0]);
+    EXPECT_TRUE(e.add);
+    EXPECT_EQ(2, e.ifidx());
+    auto& u = std::get<EventReader::Undecoded>(items[1]);
+    EXPECT_EQ(RTM_DELADDR, u.hdr.nlmsg_type);
+    EXPECT_EQ(sizeof(ifa), u.data.size());
+
+    EXPECT_FALSE(reader.takeResync());
+    auto stats = reader.getStats();
+    EXPECT_EQ(16, stats.capacity);
+    EXPECT_LE(1, stats.wakes);
+    EXPECT_LE(1, stats.maxDepth);
+    EXPECT_EQ(0, stats.dropped);
+}
+
+TEST_F(EventReaderTest, Overflow)
+{
+    EventReader reader(rx.get(), 2);
+
+    ndmsg ndm{};
+    for (int i = 1; i <= 8; ++i)
+    {
+        ndm.ndm_ifindex = i;
+        sendMsg(RTM_NEWNEIGH, ndm);
+    }
+
+    // Nothing is drained until the reader has hit the limit
+    while (reader.getStats().dropped + 2 < 8)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(2, wait(reader, 2).size());
+    EXPECT_TRUE(reader.takeResync());
+    EXPECT_FALSE(reader.takeResync());
+}
+
+} // namespace netlink
+} // namespace phosphor::network
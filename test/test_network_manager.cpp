@@ -8,6 +8,7 @@
 #include <stdplus/gtest/tmp.hpp>
 
 #include <filesystem>
+#include <unordered_map>
 
 #include <gtest/gtest.h>
 
@@ -91,5 +92,73 @@ TEST_F(TestNetworkManager, WithVLAN)
     EXPECT_TRUE(std::filesystem::is_regular_file(netdev2));
 }
 
+TEST_F(TestNetworkManager, IntfIndex)
+{
+    manager.addInterface(
+        {.type = ARPHRD_ETHER, .idx = 1, .flags = 0, .name = "eth0"});
+    manager.handleAdminState("managed", 1);
+    EXPECT_NO_THROW(manager.vlan("eth0", 2));
+
+    // The VLAN is only known by name until its link shows up
+    auto vlan = manager.interfaces.find("eth0.2")->second.get();
+    manager.handleAdminState("managed", 5);
+    manager.addInterface(
+        {.type = ARPHRD_ETHER, .idx = 5, .flags = 0, .name = "eth0.2"});
+    EXPECT_EQ(vlan, manager.intfs.intf(5));
+    EXPECT_EQ(5, vlan->getIfIdx());
+
+    // A rename recreates the object under the new name
+    manager.addInterface(
+        {.type = ARPHRD_ETHER, .idx = 5, .flags = 0, .name = "vlan2"});
+    EXPECT_THAT(manager.interfaces,
+                UnorderedElementsAre(Key("eth0"), Key("vlan2")));
+    EXPECT_EQ(manager.interfaces.find("vlan2")->second.get(),
+              manager.intfs.intf(5));
+
+    // Links removed without a name are found through their index
+    manager.removeInterface({.type = ARPHRD_ETHER, .idx = 5, .flags = 0});
+    EXPECT_THAT(manager.interfaces, UnorderedElementsAre(Key("eth0")));
+    EXPECT_EQ(nullptr, manager.intfs.intf(5));
+
+    // Becoming ignored drops the object
+    manager.addInterface({.type = ARPHRD_LOOPBACK, .idx = 1, .flags = 0});
+    EXPECT_TRUE(manager.interfaces.empty());
+    EXPECT_TRUE(manager.intfs.ignored(1));
+    EXPECT_EQ(nullptr, manager.intfs.intf(1));
+}
+
+TEST_F(TestNetworkManager, Reconcile)
+{
+    manager.addInterface(
+        {.type = ARPHRD_ETHER, .idx = 1, .flags = 0, .name = "eth0"});
+    manager.addInterface(
+        {.type = ARPHRD_ETHER, .idx = 2, .flags = 0, .name = "eth1"});
+    manager.handleAdminState("managed", 1);
+    manager.handleAdminState("managed", 2);
+    const AddressInfo keep{.ifidx = 1,
+                           .ifaddr = {stdplus::In4Addr{10, 0, 0, 1}, 24},
+                           .scope = 0,
+                           .flags = 0};
+    const AddressInfo stale{.ifidx = 1,
+                            .ifaddr = {stdplus::In4Addr{10, 0, 0, 2}, 24},
+                            .scope = 0,
+                            .flags = 0};
+    manager.addAddress(keep);
+    manager.addAddress(stale);
+
+    // eth1 and one of the addresses went away while events were lost
+    std::unordered_map<unsigned, AllIntfInfo> state;
+    state[1].intf = {.type = ARPHRD_ETHER, .idx = 1, .flags = 0,
+                     .name = "eth0"};
+    state[1].addrs.emplace(keep.ifaddr, keep);
+    EXPECT_EQ(2, manager.reconcile(state));
+    EXPECT_THAT(manager.interfaces, UnorderedElementsAre(Key("eth0")));
+    EXPECT_THAT(manager.interfaces.find("eth0")->second->addrs,
+                UnorderedElementsAre(Key(keep.ifaddr)));
+
+    // A matching dump changes nothing
+    EXPECT_EQ(0, manager.reconcile(state));
+}
+
 } // namespace network
 } // namespace phosphor
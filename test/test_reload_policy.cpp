@@ -0,0 +1,83 @@
+#include "reload_policy.hpp"
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+using std::literals::chrono_literals::operator""ms;
+
+class TestReloadPolicy : public testing::Test
+{
+  protected:
+    ReloadPolicy policy{
+        {.initial = 200ms, .window = 1000ms, .maxLatency = 3000ms}};
+    ReloadPolicy::Clock::time_point t0 = ReloadPolicy::Clock::now();
+};
+
+TEST_F(TestReloadPolicy, Isolated)
+{
+    EXPECT_FALSE(policy.pending());
+    EXPECT_EQ(t0 + 200ms, policy.schedule(t0));
+    EXPECT_TRUE(policy.pending());
+    policy.executed(t0 + 200ms);
+    EXPECT_FALSE(policy.pending());
+
+    // A change after the batch ran starts a new one
+    EXPECT_EQ(t0 + 5200ms, policy.schedule(t0 + 5000ms));
+}
+
+TEST_F(TestReloadPolicy, Burst)
+{
+    policy.schedule(t0);
+    EXPECT_EQ(t0 + 1100ms, policy.schedule(t0 + 100ms));
+    // The window never pulls the deadline in
+    EXPECT_EQ(t0 + 1100ms, policy.schedule(t0 + 100ms));
+    EXPECT_EQ(t0 + 1500ms, policy.schedule(t0 + 500ms));
+}
+
+TEST_F(TestReloadPolicy, MaxLatency)
+{
+    // A steady drip of changes cannot postpone the batch forever
+    policy.schedule(t0);
+    for (auto t = t0; t < t0 + 10000ms; t += 500ms)
+    {
+        EXPECT_GE(t0 + 3000ms, policy.schedule(t));
+    }
+    EXPECT_EQ(t0 + 3000ms, policy.schedule(t0 + 2900ms));
+}
+
+TEST_F(TestReloadPolicy, PastDeadline)
+{
+    // The batch should have run already, the caller has to fire at once
+    policy.schedule(t0);
+    auto deadline = policy.schedule(t0 + 5000ms);
+    EXPECT_EQ(t0 + 3000ms, deadline);
+    EXPECT_LT(deadline, t0 + 5000ms);
+    EXPECT_TRUE(policy.pending());
+
+    policy.executed(t0 + 5000ms);
+    EXPECT_EQ(5000ms, policy.getStats().lastLatency);
+    EXPECT_EQ(t0 + 5200ms, policy.schedule(t0 + 5000ms));
+}
+
+TEST_F(TestReloadPolicy, Stats)
+{
+    policy.executed(t0);
+    EXPECT_EQ(0, policy.getStats().executed);
+
+    policy.schedule(t0);
+    policy.schedule(t0 + 100ms);
+    policy.executed(t0 + 1100ms);
+    policy.schedule(t0 + 2000ms);
+    policy.executed(t0 + 2200ms);
+
+    const auto& stats = policy.getStats();
+    EXPECT_EQ(3, stats.scheduled);
+    EXPECT_EQ(2, stats.executed);
+    EXPECT_EQ(200ms, stats.lastLatency);
+    EXPECT_EQ(1100ms, stats.maxLatency);
+    EXPECT_EQ(1300ms, stats.totalLatency);
+}
+
+} // namespace phosphor::network
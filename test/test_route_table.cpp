@@ -0,0 +1,171 @@
+#include "route_table.hpp"
+
+#include <arpa/inet.h>
+#include <linux/rtnetlink.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network
+{
+
+using stdplus::operator""_sub;
+using stdplus::operator""_ip;
+
+static RouteInfo route(stdplus::SubnetAny dst, unsigned ifidx,
+                       uint32_t table = RT_TABLE_MAIN, uint32_t priority = 0)
+{
+    return RouteInfo{.table = table,
+                     .dst = dst,
+                     .priority = priority,
+                     .nextHops = {NextHop{.ifidx = ifidx}}};
+}
+
+static unsigned via(const RouteTable& t, stdplus::InAnyAddr addr)
+{
+    auto ret = t.lookup(addr);
+    return ret == nullptr ? 0 : ret->nextHops.at(0).ifidx;
+}
+
+TEST(RouteTable, LongestMatch)
+{
+    RouteTable t;
+    t.add(route("0.0.0.0/0"_sub, 1));
+    t.add(route("10.0.0.0/8"_sub, 2));
+    t.add(route("10.1.0.0/16"_sub, 3));
+    t.add(route("10.1.2.0/24"_sub, 4));
+    t.add(route("10.1.2.3/32"_sub, 5));
+    t.add(route("10.128.0.0/9"_sub, 6));
+    EXPECT_EQ(6, t.size());
+
+    EXPECT_EQ(1, via(t, "192.168.0.1"_ip));
+    EXPECT_EQ(2, via(t, "10.2.0.1"_ip));
+    EXPECT_EQ(3, via(t, "10.1.3.1"_ip));
+    EXPECT_EQ(4, via(t, "10.1.2.4"_ip));
+    EXPECT_EQ(5, via(t, "10.1.2.3"_ip));
+    EXPECT_EQ(6, via(t, "10.200.0.1"_ip));
+    EXPECT_EQ(0, via(t, "::1"_ip));
+
+    EXPECT_TRUE(t.remove(route("10.1.0.0/16"_sub, 3)));
+    EXPECT_FALSE(t.remove(route("10.1.0.0/16"_sub, 3)));
+    EXPECT_FALSE(t.remove(route("10.1.0.0/15"_sub, 3)));
+    EXPECT_EQ(2, via(t, "10.1.3.1"_ip));
+    EXPECT_EQ(4, via(t, "10.1.2.4"_ip));
+
+    EXPECT_TRUE(t.remove(route("0.0.0.0/0"_sub, 1)));
+    EXPECT_EQ(0, via(t, "192.168.0.1"_ip));
+    EXPECT_EQ(4, t.size());
+}
+
+TEST(RouteTable, Identity)
+{
+    RouteTable t;
+    t.add(route("10.0.0.0/8"_sub, 2, RT_TABLE_MAIN, 100));
+    t.add(route("10.0.0.0/8"_sub, 3, RT_TABLE_MAIN, 50));
+    EXPECT_EQ(3, via(t, "10.0.0.1"_ip));
+    // Same tos and priority replaces the route
+    t.add(route("10.0.0.0/8"_sub, 4, RT_TABLE_MAIN, 50));
+    EXPECT_EQ(2, t.size());
+    EXPECT_EQ(4, via(t, "10.0.0.1"_ip));
+    EXPECT_TRUE(t.remove(route("10.0.0.0/8"_sub, 4, RT_TABLE_MAIN, 50)));
+    EXPECT_EQ(2, via(t, "10.0.0.1"_ip));
+
+    // Local routes win under the default rules
+    t.add(route("10.0.0.1/32"_sub, 1, RT_TABLE_LOCAL));
+    t.add(route("10.0.0.1/32"_sub, 9, 100));
+    EXPECT_EQ(1, via(t, "10.0.0.1"_ip));
+    EXPECT_EQ(9, t.lookup("10.0.0.1"_ip, 100)->nextHops[0].ifidx);
+    EXPECT_EQ(nullptr, t.lookup("10.0.0.2"_ip, 100));
+
+    std::vector<uint32_t> tables;
+    t.forEach([&](const RouteInfo& r) { tables.push_back(r.table); });
+    EXPECT_EQ((std::vector<uint32_t>{100, RT_TABLE_MAIN, RT_TABLE_LOCAL}),
+              tables);
+}
+
+TEST(RouteTable, Multipath)
+{
+    RouteTable t;
+    auto r = route("2001:db8::/32"_sub, 2);
+    t.add(RouteInfo(r));
+    r.nextHops = {NextHop{.ifidx = 3, .gateway = "fe80::1"_ip}};
+    t.add(RouteInfo(r), true);
+    t.add(RouteInfo(r), true);
+    ASSERT_NE(nullptr, t.lookup("2001:db8::1"_ip));
+    EXPECT_EQ(2, t.lookup("2001:db8::1"_ip)->nextHops.size());
+
+    // Only the listed sibling goes away
+    EXPECT_TRUE(t.remove(r));
+    ASSERT_NE(nullptr, t.lookup("2001:db8::1"_ip));
+    EXPECT_EQ(1, t.lookup("2001:db8::1"_ip)->nextHops.size());
+    EXPECT_EQ(2, via(t, "2001:db8::1"_ip));
+    EXPECT_TRUE(t.remove(route("2001:db8::/32"_sub, 2)));
+    EXPECT_EQ(0, t.size());
+}
+
+/** @brief Checks lookups against a linear scan with a routing table the
+ *         size of a full feed slice
+ */
+TEST(RouteTable, LinearScan)
+{
+    constexpr size_t routes = 50000;
+    std::mt19937 rng(1);
+
+    struct Prefix
+    {
+        uint32_t addr;
+        uint8_t len;
+    };
+    std::vector<Prefix> prefixes;
+    auto toSubnet = [](const Prefix& p) {
+        return stdplus::SubnetAny{
+            stdplus::In4Addr(in_addr{htonl(p.addr)}), p.len};
+    };
+    while (prefixes.size() < routes)
+    {
+        uint8_t len = 8 + rng() % 25;
+        uint32_t addr = rng() & ~(len == 32 ? 0 : 0xffffffffu >> len);
+        prefixes.push_back({addr, len});
+    }
+
+    RouteTable t;
+    for (size_t i = 0; i < prefixes.size(); ++i)
+    {
+        t.add(route(toSubnet(prefixes[i]), i + 1));
+    }
+
+    // Duplicate prefixes replace each other, so the latest one wins
+    auto scan = [&](uint32_t addr) {
+        unsigned best = 0;
+        int bestLen = -1;
+        for (size_t i = 0; i < prefixes.size(); ++i)
+        {
+            const auto& p = prefixes[i];
+            uint32_t mask = p.len == 0 ? 0 : 0xffffffffu << (32 - p.len);
+            if ((addr & mask) == p.addr && p.len >= bestLen)
+            {
+                best = i + 1;
+                bestLen = p.len;
+            }
+        }
+        return best;
+    };
+    for (size_t i = 0; i < 200; ++i)
+    {
+        // Aim at existing prefixes so most lookups hit something
+        uint32_t addr = prefixes[rng() % prefixes.size()].addr;
+        addr |= rng() & 0xff;
+        ASSERT_EQ(scan(addr), via(t, stdplus::In4Addr(in_addr{htonl(addr)})));
+    }
+
+    for (size_t i = 0; i < prefixes.size(); ++i)
+    {
+        t.remove(route(toSubnet(prefixes[i]), i + 1));
+    }
+    EXPECT_EQ(0, t.size());
+}
+
+} // namespace phosphor::network
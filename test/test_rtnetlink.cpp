@@ -1,10 +1,18 @@
 #include "rtnetlink.hpp"
 
+#include <linux/neighbour.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <sys/socket.h>
 
+#include <stdplus/fd/managed.hpp>
 #include <stdplus/raw.hpp>
 
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+
 #include <gtest/gtest.h>
 
 namespace phosphor::network::netlink
@@ -65,6 +73,47 @@ TEST(IntfFromRtm, AllAttrs)
     EXPECT_EQ(info, expected);
 }
 
+TEST(StatsFromRtm, NoStats)
+{
+    struct
+    {
+        ifinfomsg hdr __attribute__((aligned(NLMSG_ALIGNTO)));
+    } msg = {};
+    EXPECT_EQ(std::nullopt, statsFromRtm(stdplus::raw::asView<char>(msg)));
+}
+
+TEST(StatsFromRtm, Stats64)
+{
+    ifinfomsg ifi = {};
+    ifi.ifi_index = 2;
+    rtnl_link_stats64 stats = {};
+    stats.rx_bytes = 1000;
+    stats.tx_errors = 3;
+    auto msg = [&](size_t statsLen) {
+        rtattr hdr = {};
+        hdr.rta_type = IFLA_STATS64;
+        hdr.rta_len = RTA_LENGTH(statsLen);
+        std::string ret(NLMSG_ALIGN(sizeof(ifi)) + RTA_SPACE(statsLen), '\0');
+        std::memcpy(ret.data(), &ifi, sizeof(ifi));
+        std::memcpy(ret.data() + NLMSG_ALIGN(sizeof(ifi)), &hdr, sizeof(hdr));
+        std::memcpy(ret.data() + NLMSG_ALIGN(sizeof(ifi)) + RTA_LENGTH(0),
+                    &stats, statsLen);
+        return ret;
+    };
+
+    auto ret = statsFromRtm(msg(sizeof(stats)));
+    ASSERT_TRUE(ret);
+    EXPECT_EQ(2, std::get<0>(*ret));
+    EXPECT_EQ(1000, std::get<1>(*ret).rx_bytes);
+    EXPECT_EQ(3, std::get<1>(*ret).tx_errors);
+
+    // Older kernels report a shorter struct
+    ret = statsFromRtm(msg(offsetof(rtnl_link_stats64, tx_errors)));
+    ASSERT_TRUE(ret);
+    EXPECT_EQ(1000, std::get<1>(*ret).rx_bytes);
+    EXPECT_EQ(0, std::get<1>(*ret).tx_errors);
+}
+
 TEST(AddrFromRtm, MissingAddr)
 {
     struct
@@ -168,4 +217,204 @@ TEST(NeighFromRtm, Full)
     EXPECT_EQ((ether_addr{1, 2, 3, 4, 5, 6}), ret.mac);
 }
 
+TEST(RouteFromRtm, Multipath)
+{
+    struct
+    {
+        alignas(NLMSG_ALIGNTO) rtmsg rtm;
+        alignas(NLMSG_ALIGNTO) rtattr table_hdr;
+        alignas(NLMSG_ALIGNTO) uint32_t table = 100;
+        alignas(NLMSG_ALIGNTO) rtattr dst_hdr;
+        alignas(NLMSG_ALIGNTO) uint8_t dst[4] = {10, 1, 0, 0};
+        alignas(NLMSG_ALIGNTO) rtattr prio_hdr;
+        alignas(NLMSG_ALIGNTO) uint32_t prio = 20;
+        alignas(NLMSG_ALIGNTO) rtattr mp_hdr;
+        alignas(NLMSG_ALIGNTO) rtnexthop nh1;
+        alignas(NLMSG_ALIGNTO) rtattr gw1_hdr;
+        alignas(NLMSG_ALIGNTO) uint8_t gw1[4] = {10, 0, 0, 1};
+        alignas(NLMSG_ALIGNTO) rtnexthop nh2;
+        alignas(NLMSG_ALIGNTO) rtattr gw2_hdr;
+        alignas(NLMSG_ALIGNTO) uint8_t gw2[4] = {10, 0, 0, 2};
+    } msg;
+    std::memset(&msg.rtm, 0, sizeof(msg.rtm));
+    msg.rtm.rtm_family = AF_INET;
+    msg.rtm.rtm_dst_len = 16;
+    msg.rtm.rtm_table = RT_TABLE_COMPAT;
+    msg.rtm.rtm_type = RTN_UNICAST;
+    msg.table_hdr.rta_type = RTA_TABLE;
+    msg.table_hdr.rta_len = RTA_LENGTH(sizeof(msg.table));
+    msg.dst_hdr.rta_type = RTA_DST;
+    msg.dst_hdr.rta_len = RTA_LENGTH(sizeof(msg.dst));
+    msg.prio_hdr.rta_type = RTA_PRIORITY;
+    msg.prio_hdr.rta_len = RTA_LENGTH(sizeof(msg.prio));
+    msg.mp_hdr.rta_type = RTA_MULTIPATH;
+    msg.mp_hdr.rta_len = RTA_LENGTH(2 * (sizeof(rtnexthop) + RTA_LENGTH(4)));
+    msg.nh1 = {.rtnh_len = RTNH_LENGTH(RTA_LENGTH(4)),
+               .rtnh_flags = 0,
+               .rtnh_hops = 0,
+               .rtnh_ifindex = 2};
+    msg.gw1_hdr.rta_type = RTA_GATEWAY;
+    msg.gw1_hdr.rta_len = RTA_LENGTH(sizeof(msg.gw1));
+    msg.nh2 = {.rtnh_len = RTNH_LENGTH(RTA_LENGTH(4)),
+               .rtnh_flags = 0,
+               .rtnh_hops = 1,
+               .rtnh_ifindex = 3};
+    msg.gw2_hdr.rta_type = RTA_GATEWAY;
+    msg.gw2_hdr.rta_len = RTA_LENGTH(sizeof(msg.gw2));
+
+    auto ret = routeFromRtm(stdplus::raw::asView<char>(msg));
+    EXPECT_EQ(100, ret.table);
+    EXPECT_EQ("10.1.0.0/16"_sub, ret.dst);
+    EXPECT_EQ(20, ret.priority);
+    EXPECT_EQ(RTN_UNICAST, ret.type);
+    ASSERT_EQ(2, ret.nextHops.size());
+    EXPECT_EQ((NextHop{.ifidx = 2, .gateway = "10.0.0.1"_ip, .weight = 1}),
+              ret.nextHops[0]);
+    EXPECT_EQ((NextHop{.ifidx = 3, .gateway = "10.0.0.2"_ip, .weight = 2}),
+              ret.nextHops[1]);
+}
+
+TEST(RouteFromRtm, Default)
+{
+    struct
+    {
+        alignas(NLMSG_ALIGNTO) rtmsg rtm;
+        alignas(NLMSG_ALIGNTO) rtattr oif_hdr;
+        alignas(NLMSG_ALIGNTO) uint32_t oif = 4;
+    } msg;
+    std::memset(&msg.rtm, 0, sizeof(msg.rtm));
+    msg.rtm.rtm_family = AF_INET6;
+    msg.rtm.rtm_table = RT_TABLE_MAIN;
+    msg.oif_hdr.rta_type = RTA_OIF;
+    msg.oif_hdr.rta_len = RTA_LENGTH(sizeof(msg.oif));
+
+    auto ret = routeFromRtm(stdplus::raw::asView<char>(msg));
+    EXPECT_EQ(RT_TABLE_MAIN, ret.table);
+    EXPECT_EQ("::/0"_sub, ret.dst);
+    ASSERT_EQ(1, ret.nextHops.size());
+    EXPECT_EQ(NextHop{.ifidx = 4}, ret.nextHops[0]);
+}
+
+class EventFilter : public testing::Test
+{
+  protected:
+    stdplus::ManagedFd rx, tx;
+
+    EventFilter()
+    {
+        // Socket filters behave the same on any datagram socket
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds) < 0)
+        {
+            throw std::system_error(errno, std::generic_category());
+        }
+        rx = stdplus::ManagedFd(std::move(fds[0]));
+        tx = stdplus::ManagedFd(std::move(fds[1]));
+    }
+
+    void attach(const std::unordered_set<unsigned>& ignored,
+                bool allRoutes = false, bool allNeighbors = false)
+    {
+        auto prog = eventFilter(ignored, allRoutes, allNeighbors);
+        sock_fprog fprog{};
+        fprog.len = prog.size();
+        fprog.filter = prog.data();
+        ASSERT_EQ(0, setsockopt(rx.get(), SOL_SOCKET, SO_ATTACH_FILTER,
+                                &fprog, sizeof(fprog)));
+    }
+
+    template <typename T>
+    bool passes(uint16_t type, const T& body)
+    {
+        std::string buf(NLMSG_SPACE(sizeof(body)), '\0');
+        nlmsghdr hdr{};
+        hdr.nlmsg_len = NLMSG_LENGTH(sizeof(body));
+        hdr.nlmsg_type = type;
+        std::memcpy(buf.data(), &hdr, sizeof(hdr));
+        std::memcpy(buf.data() + NLMSG_HDRLEN, &body, sizeof(body));
+        EXPECT_EQ(buf.size(), send(tx.get(), buf.data(), buf.size(), 0));
+        char out[256];
+        return recv(rx.get(), out, sizeof(out), 0) > 0;
+    }
+};
+
+static ifinfomsg link(int idx)
+{
+    ifinfomsg msg{};
+    msg.ifi_index = idx;
+    return msg;
+}
+
+static ifaddrmsg addr(unsigned idx)
+{
+    ifaddrmsg msg{};
+    msg.ifa_index = idx;
+    return msg;
+}
+
+static ndmsg neigh(int idx, uint16_t state)
+{
+    ndmsg msg{};
+    msg.ndm_ifindex = idx;
+    msg.ndm_state = state;
+    return msg;
+}
+
+static rtmsg route(uint8_t table)
+{
+    rtmsg msg{};
+    msg.rtm_table = table;
+    return msg;
+}
+
+TEST_F(EventFilter, Drops)
+{
+    attach({3, 7});
+
+    EXPECT_TRUE(passes(RTM_NEWLINK, link(3)));
+    EXPECT_TRUE(passes(RTM_DELLINK, link(7)));
+
+    EXPECT_TRUE(passes(RTM_NEWADDR, addr(2)));
+    EXPECT_FALSE(passes(RTM_NEWADDR, addr(3)));
+    EXPECT_FALSE(passes(RTM_DELADDR, addr(7)));
+
+    EXPECT_TRUE(passes(RTM_NEWNEIGH, neigh(2, NUD_PERMANENT)));
+    EXPECT_FALSE(passes(RTM_NEWNEIGH, neigh(2, NUD_REACHABLE)));
+    EXPECT_FALSE(passes(RTM_NEWNEIGH, neigh(3, NUD_PERMANENT)));
+    EXPECT_TRUE(passes(RTM_DELNEIGH, neigh(2, NUD_FAILED)));
+
+    EXPECT_TRUE(passes(RTM_NEWROUTE, route(RT_TABLE_MAIN)));
+    EXPECT_FALSE(passes(RTM_NEWROUTE, route(RT_TABLE_LOCAL)));
+    EXPECT_FALSE(passes(RTM_DELROUTE, route(100)));
+}
+
+TEST_F(EventFilter, ManyIgnored)
+{
+    std::unordered_set<unsigned> ignored;
+    for (unsigned i = 1; i <= maxFilteredIntfs * 2; ++i)
+    {
+        ignored.emplace(i);
+    }
+    attach(ignored);
+    EXPECT_TRUE(passes(RTM_NEWLINK, link(1)));
+    EXPECT_FALSE(passes(RTM_NEWNEIGH, neigh(1, NUD_STALE)));
+}
+
+TEST_F(EventFilter, AllRoutes)
+{
+    attach({3}, true);
+    EXPECT_TRUE(passes(RTM_NEWROUTE, route(RT_TABLE_LOCAL)));
+    EXPECT_TRUE(passes(RTM_DELROUTE, route(100)));
+    EXPECT_FALSE(passes(RTM_NEWADDR, addr(3)));
+}
+
+TEST_F(EventFilter, AllNeighbors)
+{
+    attach({3}, false, true);
+    EXPECT_TRUE(passes(RTM_NEWNEIGH, neigh(2, NUD_REACHABLE)));
+    EXPECT_TRUE(passes(RTM_NEWNEIGH, neigh(2, NUD_STALE)));
+    EXPECT_FALSE(passes(RTM_NEWNEIGH, neigh(3, NUD_REACHABLE)));
+    EXPECT_FALSE(passes(RTM_NEWROUTE, route(RT_TABLE_LOCAL)));
+}
+
 } // namespace phosphor::network::netlink
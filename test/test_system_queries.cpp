@@ -0,0 +1,119 @@
+#include "mock_syscall.hpp"
+#include "netlink.hpp"
+#include "system_queries.hpp"
+
+#include <linux/neighbour.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace phosphor::network::system
+{
+
+using stdplus::operator""_ip;
+using stdplus::operator""_sub;
+
+class ApplyNow : public testing::Test
+{
+  protected:
+    ApplyNow()
+    {
+        mock_clear();
+    }
+
+    /** @brief Checks that exactly one message was sent and splits it */
+    template <typename T>
+    static auto onlyRequest(uint16_t type)
+    {
+        const auto& reqs = mock_nlRequests();
+        EXPECT_EQ(1, reqs.size());
+        std::string_view req = reqs.back();
+        const auto& hdr = netlink::extractRtData<nlmsghdr>(req);
+        EXPECT_EQ(type, hdr.nlmsg_type);
+        EXPECT_EQ(NLM_F_REQUEST | NLM_F_ACK,
+                  hdr.nlmsg_flags & (NLM_F_REQUEST | NLM_F_ACK));
+        auto [msg, attrs] = netlink::parseRtm<T>(req);
+        return std::make_tuple(hdr.nlmsg_flags, msg, attrs);
+    }
+};
+
+TEST_F(ApplyNow, Address)
+{
+    addAddress(2, "192.168.1.2/24"_sub);
+    {
+        auto [flags, msg, attrs] = onlyRequest<ifaddrmsg>(RTM_NEWADDR);
+        EXPECT_EQ(NLM_F_CREATE | NLM_F_REPLACE,
+                  flags & (NLM_F_CREATE | NLM_F_REPLACE));
+        EXPECT_EQ(AF_INET, msg.ifa_family);
+        EXPECT_EQ(24, msg.ifa_prefixlen);
+        EXPECT_EQ(2, msg.ifa_index);
+        EXPECT_EQ((stdplus::In4Addr{192, 168, 1, 2}),
+                  attrs.get<stdplus::In4Addr>(IFA_LOCAL));
+        EXPECT_EQ((stdplus::In4Addr{192, 168, 1, 255}),
+                  attrs.get<stdplus::In4Addr>(IFA_BROADCAST));
+    }
+
+    mock_clear();
+    deleteAddress(2, "fd00::2/64"_sub);
+    {
+        auto [flags, msg, attrs] = onlyRequest<ifaddrmsg>(RTM_DELADDR);
+        EXPECT_EQ(AF_INET6, msg.ifa_family);
+        EXPECT_EQ(64, msg.ifa_prefixlen);
+        auto local = attrs.get<stdplus::In6Addr>(IFA_LOCAL);
+        ASSERT_TRUE(local);
+        EXPECT_EQ("fd00::2"_ip, stdplus::InAnyAddr(*local));
+        EXPECT_FALSE(attrs.contains(IFA_BROADCAST));
+    }
+}
+
+TEST_F(ApplyNow, DefaultRoute)
+{
+    addDefaultRoute(3, "10.0.0.1"_ip, /*onlink=*/true);
+    {
+        auto [flags, msg, attrs] = onlyRequest<rtmsg>(RTM_NEWROUTE);
+        EXPECT_EQ(NLM_F_CREATE, flags & (NLM_F_CREATE | NLM_F_REPLACE));
+        EXPECT_EQ(AF_INET, msg.rtm_family);
+        EXPECT_EQ(0, msg.rtm_dst_len);
+        EXPECT_EQ(RT_TABLE_MAIN, msg.rtm_table);
+        EXPECT_EQ(RTNH_F_ONLINK, msg.rtm_flags);
+        EXPECT_EQ((stdplus::In4Addr{10, 0, 0, 1}),
+                  attrs.get<stdplus::In4Addr>(RTA_GATEWAY));
+        EXPECT_EQ(3, attrs.get<uint32_t>(RTA_OIF));
+    }
+
+    mock_clear();
+    deleteDefaultRoute(3, "fe80::1"_ip);
+    {
+        auto [flags, msg, attrs] = onlyRequest<rtmsg>(RTM_DELROUTE);
+        EXPECT_EQ(AF_INET6, msg.rtm_family);
+        EXPECT_EQ(0, msg.rtm_flags);
+        EXPECT_EQ(3, attrs.get<uint32_t>(RTA_OIF));
+    }
+}
+
+TEST_F(ApplyNow, Neighbor)
+{
+    constexpr stdplus::EtherAddr mac{0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    addNeighbor(4, "10.0.0.9"_ip, mac);
+    {
+        auto [flags, msg, attrs] = onlyRequest<ndmsg>(RTM_NEWNEIGH);
+        EXPECT_EQ(AF_INET, msg.ndm_family);
+        EXPECT_EQ(4, msg.ndm_ifindex);
+        EXPECT_EQ(NUD_PERMANENT, msg.ndm_state);
+        EXPECT_EQ(mac, attrs.get<stdplus::EtherAddr>(NDA_LLADDR));
+    }
+
+    mock_clear();
+    deleteNeighbor(4, "10.0.0.9"_ip);
+    {
+        auto [flags, msg, attrs] = onlyRequest<ndmsg>(RTM_DELNEIGH);
+        EXPECT_EQ((stdplus::In4Addr{10, 0, 0, 9}),
+                  attrs.get<stdplus::In4Addr>(NDA_DST));
+        EXPECT_FALSE(attrs.contains(NDA_LLADDR));
+    }
+}
+
+} // namespace phosphor::network::system